@@ -13,6 +13,9 @@ name = "iden3math"
 version = "{}"
 requires-python = ">=3.8,<3.14"
 
+[project.optional-dependencies]
+numpy = ["numpy"] # Batch functions taking and returning arrays
+
 [tool.scikit-build]
 cmake.minimum-version = "3.18"
 cmake.verbose = false
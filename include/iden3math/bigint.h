@@ -6,7 +6,10 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 
 #define IDEN3MATH_BIGINT_OP_ARITHMETIC_BITWISE(op) \
     BigInt operator op(const BigInt& rhs) const; \
@@ -30,7 +33,7 @@
     void operator op##=(const BigInt& rhs); \
     void operator op##=(uint32_t rhs); \
     template <typename T, enable_if_int_t<T> = 0> \
-        friend BigInt operator op(const BigInt& a, const T& b) { return a op b; } \
+        friend BigInt operator op(const BigInt& a, const T& b) { return a op shift_count(b); } \
 
 #define IDEN3MATH_BIGINT_OP_LOGIC(op) \
     bool operator op(const BigInt& rhs) const; \
@@ -69,6 +72,8 @@ public:
      */
     BigInt(const ByteVec1D& bytes, Endian endian);
     BigInt(const std::string& num, int32_t base);
+    // Same as the ByteVec1D constructor, reads the caller's memory in place
+    [[nodiscard]] static BigInt from_bytes(std::span<const uint8_t> bytes, Endian endian);
 
     // Copy && move constructors
     BigInt(const Impl& other);
@@ -95,12 +100,26 @@ public:
      *                  BIG:   (High Addr){0xff, 0xee, 0x00, 0x22}(Low Addr) -> 0xffee002211
      */
     [[nodiscard]] ByteVec1D bytes(Endian endian) const;
+    /**
+     * Write the magnitude zero-padded to exactly out.size() bytes into the caller's memory
+     * @param   endian  Same layout as bytes(), BIG puts the padding at the low address
+     * @throws  std::out_of_range if the magnitude does not fit in out.size() bytes
+     */
+    void to_bytes_fixed(std::span<uint8_t> out, Endian endian) const;
     [[nodiscard]] size_t bits_size() const; // Faster than bits().size()
     [[nodiscard]] size_t bytes_size() const; // Faster than bytes().size()
     [[nodiscard]] BigInt pow(const uint32_t& exp) const;
     [[nodiscard]] BigInt pow_mod(const BigInt& exp, const BigInt& modulo) const;
     [[nodiscard]] std::optional<BigInt> mod_inv(const BigInt& modulo) const;
 
+public:
+    // Destination-passing forms for hot loops, out reuses its own storage and may alias any operand
+    static void add(BigInt& out, const BigInt& a, const BigInt& b);
+    static void sub(BigInt& out, const BigInt& a, const BigInt& b);
+    static void mul(BigInt& out, const BigInt& a, const BigInt& b);
+    static void mod(BigInt& out, const BigInt& a, const BigInt& b); // Same sign as a, like operator%
+    static void powm(BigInt& out, const BigInt& base, const BigInt& exp, const BigInt& modulo);
+
 public:
     BigInt& operator=(const BigInt& other);
     BigInt& operator=(BigInt&& other) noexcept;
@@ -121,9 +140,9 @@ public:
     IDEN3MATH_BIGINT_OP_LOGIC(<=)
     IDEN3MATH_BIGINT_OP_LOGIC(>=)
     BigInt& operator++();
-    BigInt  operator++(int) const;
+    BigInt  operator++(int);
     BigInt& operator--();
-    BigInt  operator--(int) const;
+    BigInt  operator--(int);
     BigInt  operator+() const;
     BigInt  operator-() const;
     BigInt  operator~() const;
@@ -132,7 +151,29 @@ public:
     friend std::ostream& operator<<(std::ostream& os, const BigInt& a) { return os << a.str(); }
 
 private:
+    // Static helpers over both storage modes, defined with the implementation
+    class Storage;
+
+    // Shift count of any integer type, throws std::invalid_argument when it is negative or does not fit in 32 bits
+    template <typename T>
+    static uint32_t shift_count(const T& count) {
+        if constexpr (std::is_signed_v<T>) {
+            if (count < 0) {
+                throw std::invalid_argument("Negative BigInt shift count");
+            }
+        }
+        if (static_cast<uintmax_t>(count) > UINT32_MAX) {
+            throw std::invalid_argument("BigInt shift count is too large");
+        }
+        return static_cast<uint32_t>(count);
+    }
+
+    // Values of up to INLINE_LIMBS 64-bit limbs are kept in place and impl_ stays null,
+    // only larger values spill to the GMP-backed impl_
+    static constexpr size_t INLINE_LIMBS = 4;
     std::unique_ptr<Impl> impl_;
+    int32_t size_ = 0; // Signed limb count of the inline value, same convention as GMP's _mp_size
+    uint64_t limbs_[INLINE_LIMBS] = {};
 };
 
 } // namespace iden3math
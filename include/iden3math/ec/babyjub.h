@@ -4,6 +4,10 @@
 #include <iden3math/ec/point.h>
 #include <iden3math/fp1.h>
 #include <iden3math/macro.h>
+#include <array>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace iden3math::ec::babyjub { // A * x² + y² == 1 + D * x² * y²
 
@@ -23,12 +27,50 @@ API Point add(const Point& a, const Point& b);
 
 API Point mul_scalar(const Point& p, const BigInt& k);
 
+// Signed-window (wNAF) multiplication, width in [2, 8], precomputes 2 ^ (width - 2) odd multiples of p
+API Point mul_scalar_wnaf(const Point& p, const BigInt& k, uint32_t width = 4);
+
+// Constant-time Montgomery ladder for secret scalars, p must be on the curve, k is reduced modulo group_order()
+API Point mul_scalar_ct(const Point& p, const BigInt& k);
+
+// k * generator() from a precomputed fixed-base table, k is reduced modulo group_order()
+API Point mul_base(const BigInt& k);
+
+// Sum of scalars[i] * points[i] by bucket-based Pippenger, the window size is chosen from the number of points
+// Windows are spread across the given number of threads
+API Point msm(std::span<const Point> points, std::span<const BigInt> scalars, uint32_t threads = 1);
+
+// Projective arithmetic on extended coordinates, no inversion until to_affine()
+
+API PointExt to_ext(const Point& p);
+
+API Point to_affine(const PointExt& p);
+
+// Affine form of every point with a single field inversion in total
+API std::vector<Point> normalize_batch(std::span<const PointExt> points);
+
+API PointExt add(const PointExt& a, const PointExt& b);
+
+API PointExt dbl(const PointExt& p);
+
+API PointExt mul_scalar(const PointExt& p, const BigInt& k);
+
+API PointExt mul_scalar_wnaf(const PointExt& p, const BigInt& k, uint32_t width = 4);
+
+API PointExt mul_scalar_ct(const PointExt& p, const BigInt& k);
+
 API bool in_sub_group(const Point& p);
 
 API bool in_curve(const Point& p);
 
 API ByteVec1D compress(const Point& p, Endian endian);
 
-API std::optional<Point> decompress(ByteVec1D packed, Endian endian);
+// Same as compress() on every normalized point, with a single field inversion in total
+API std::vector<ByteVec1D> compress_batch(std::span<const PointExt> points, Endian endian);
+
+API std::optional<Point> decompress(const ByteVec1D& packed, Endian endian);
+
+// Same as decompress() on every 32-byte input with a single field inversion per thread, invalid inputs yield std::nullopt
+API std::vector<std::optional<Point>> decompress_batch(std::span<const std::array<uint8_t, 32>> packed, Endian endian, uint32_t threads = 1);
 
 } // namespace iden3math::ec::babyjub
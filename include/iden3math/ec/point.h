@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iden3math/bigint.h>
+#include <iden3math/fp254.h>
 #include <iden3math/macro.h>
 #include <utility>
 
@@ -18,4 +19,19 @@ public:
     BigInt y;
 };
 
+class API PointExt final { // Extended twisted Edwards coordinates, x = X / Z, y = Y / Z, x * y = T / Z
+public:
+    constexpr PointExt() : x(), y(Fp254::one()), t(), z(Fp254::one()) {} // Identity (0 : 1 : 0 : 1)
+    constexpr PointExt(Fp254 x, Fp254 y, Fp254 t, Fp254 z) : x(x), y(y), t(t), z(z) {}
+    ~PointExt() = default;
+    constexpr bool operator==(const PointExt& p) const { return x * p.z == p.x * z && y * p.z == p.y * z; }
+    constexpr bool operator!=(const PointExt& p) const { return !(*this == p); }
+
+public:
+    Fp254 x;
+    Fp254 y;
+    Fp254 t;
+    Fp254 z;
+};
+
 } // namespace iden3math::ec
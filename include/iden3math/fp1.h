@@ -1,16 +1,40 @@
 #pragma once
 
 #include <iden3math/bigint.h>
+#include <memory>
 #include <optional>
+#include <span>
 
 namespace iden3math {
 
+// Constants of GF(p) computed once per prime and shared by every Fp1 of that prime
+typedef struct FieldContext {
+    BigInt   p;
+    BigInt   p_m1_d2;     // (p - 1) / 2, Euler's criterion exponent
+    // Tonelli–Shanks square root, p - 1 = q * (2 ^ s)
+    uint32_t s;
+    BigInt   q;
+    BigInt   q_m1_d2;     // (q - 1) / 2
+    BigInt   non_residue; // Least n >= 2 with n / p = -1
+    BigInt   z;           // non_residue ^ q
+    // Montgomery form over 64-bit limbs
+    size_t   limbs;       // Number of 64-bit limbs of p
+    BigInt   r;           // 2 ^ (64 * limbs) mod p
+    BigInt   r2;          // r ^ 2 mod p
+    uint64_t n_prime;     // -p⁻¹ mod 2⁶⁴
+} FieldContext;
+
 // Operation on GF(p^1)
 class API Fp1 final {
 public:
-    Fp1(BigInt prime);
+    Fp1(BigInt prime); // Cheap after the first construction for the same prime, the context is cached process-wide
     ~Fp1() = default;
 
+public:
+    // Registry lookup, the context is computed on first use and never freed
+    [[nodiscard]] static std::shared_ptr<const FieldContext> context_of(const BigInt& prime);
+    [[nodiscard]] const FieldContext& context() const { return *ctx_; }
+
 public:
     [[nodiscard]] BigInt                mod_reduce(const BigInt& a) const;
     [[nodiscard]] BigInt                add(const BigInt& a, const BigInt& b) const;
@@ -21,17 +45,19 @@ public:
     [[nodiscard]] BigInt                square(const BigInt& a) const;
     [[nodiscard]] std::optional<BigInt> sqrt(BigInt a) const;
     [[nodiscard]] std::optional<BigInt> mod_inv(const BigInt& a) const;
+    void                                batch_inv(std::span<BigInt> a) const; // In place, elements without an inverse become 0
     [[nodiscard]] BigInt                neg(const BigInt& a) const;
     [[nodiscard]] bool                  has_sqrt(const BigInt& a) const;
 
+public:
+    // Same results as add(), sub() and mul() written into out, which may alias a or b
+    void add_into(BigInt& out, const BigInt& a, const BigInt& b) const;
+    void sub_into(BigInt& out, const BigInt& a, const BigInt& b) const;
+    void mul_into(BigInt& out, const BigInt& a, const BigInt& b) const;
+
 private:
-    const BigInt p_;
-    const uint32_t m_;
-    // Tonelli–Shanks square root, (p_ ^ m_) - 1 = q_ * (2 ^ s_)
-    int32_t s_;
-    BigInt q_;
-    BigInt q_m1_d2_;   // (q_ - 1) /  2
-    BigInt z_;         // z_ / p_ = -1
+    std::shared_ptr<const FieldContext> ctx_;
+    const BigInt& p_; // ctx_->p
 };
 
 } // namespace iden3math
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <iden3math/bigint.h>
+#include <iden3math/macro.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+    #include <intrin.h>
+#endif
+
+namespace iden3math {
+
+// Element of GF(p), p = prime::bn254(), stack-resident and allocation-free
+// Ring operations are constexpr so that tables of field elements can be built at compile time
+class API Fp254 final {
+public:
+    // Little-endian 64-bit limbs, limbs[0] is the least significant one
+    using Limbs = std::array<uint64_t, 4>;
+
+    constexpr Fp254() : m_{} {}
+    constexpr explicit Fp254(uint64_t a) : m_{a, 0, 0, 0} { mont_mul(m_, m_, R2); }
+    explicit Fp254(const BigInt& a); // Reduced modulo p, negative numbers are allowed
+    ~Fp254() = default;
+
+public:
+    // Build from limbs that are already in Montgomery form (a * 2²⁵⁶ mod p), no reduction is performed
+    static constexpr Fp254 from_mont(const Limbs& mont) {
+        Fp254 r;
+        r.m_ = mont;
+        return r;
+    }
+    // Build from plain limbs, any value below 2²⁵⁶ is accepted and reduced modulo p
+    static constexpr Fp254 from_limbs(const Limbs& limbs) {
+        Fp254 r;
+        mont_mul(r.m_, limbs, R2);
+        return r;
+    }
+    static constexpr Fp254 zero() { return {}; }
+    static constexpr Fp254 one() { return from_mont(R1); }
+    static constexpr const Limbs& modulus() { return P; }
+    // Invert every element in place with a single inversion, zeros stay zero
+    static void batch_inv(std::span<Fp254> a);
+    // Swap a and b when swap is true, branch-free on the limbs
+    static constexpr void cswap(Fp254& a, Fp254& b, bool swap) {
+        const uint64_t mask = 0 - static_cast<uint64_t>(swap);
+        for (size_t i = 0; i < 4; ++i) {
+            const uint64_t t = mask & (a.m_[i] ^ b.m_[i]);
+            a.m_[i] ^= t;
+            b.m_[i] ^= t;
+        }
+    }
+
+public:
+    [[nodiscard]] BigInt                 big_int() const;
+    [[nodiscard]] constexpr Limbs        limbs() const { Limbs r; mont_mul(r, m_, {1, 0, 0, 0}); return r; } // Canonical, non-Montgomery limbs
+    [[nodiscard]] constexpr const Limbs& mont() const { return m_; }
+    [[nodiscard]] constexpr bool         is_zero() const { return 0 == (m_[0] | m_[1] | m_[2] | m_[3]); }
+    [[nodiscard]] constexpr bool         is_one() const { return m_ == R1; }
+    [[nodiscard]] constexpr Fp254        dbl() const { Fp254 r; mod_add(r.m_, m_, m_); return r; }
+    [[nodiscard]] constexpr Fp254        square() const { Fp254 r; mont_mul(r.m_, m_, m_); return r; }
+    [[nodiscard]] Fp254                  pow(const Limbs& exp) const;
+    [[nodiscard]] Fp254                  pow(const BigInt& exp) const; // exp >= 0
+    [[nodiscard]] Fp254                  inv() const; // Inverse of zero is zero
+    [[nodiscard]] std::optional<Fp254>   sqrt() const;
+    [[nodiscard]] bool                   has_sqrt() const;
+
+public:
+    constexpr Fp254 operator+(const Fp254& rhs) const { Fp254 r; mod_add(r.m_, m_, rhs.m_); return r; }
+    constexpr Fp254 operator-(const Fp254& rhs) const { Fp254 r; mod_sub(r.m_, m_, rhs.m_); return r; }
+    constexpr Fp254 operator*(const Fp254& rhs) const { Fp254 r; mont_mul(r.m_, m_, rhs.m_); return r; }
+    constexpr Fp254 operator-() const { Fp254 r; mod_sub(r.m_, Limbs{0, 0, 0, 0}, m_); return r; }
+    constexpr Fp254& operator+=(const Fp254& rhs) { mod_add(m_, m_, rhs.m_); return *this; }
+    constexpr Fp254& operator-=(const Fp254& rhs) { mod_sub(m_, m_, rhs.m_); return *this; }
+    constexpr Fp254& operator*=(const Fp254& rhs) { mont_mul(m_, m_, rhs.m_); return *this; }
+    constexpr bool operator==(const Fp254& rhs) const { return m_ == rhs.m_; }
+    constexpr bool operator!=(const Fp254& rhs) const { return m_ != rhs.m_; }
+
+private:
+    // p = 21888242871839275222246405745257275088548364400416034343698204186575808495617
+    static constexpr Limbs P = {0x43e1f593f0000001, 0x2833e84879b97091, 0xb85045b68181585d, 0x30644e72e131a029};
+    // -p⁻¹ mod 2⁶⁴
+    static constexpr uint64_t P_INV_NEG = 0xc2e1f593efffffff;
+    // 2²⁵⁶ mod p, Montgomery form of 1
+    static constexpr Limbs R1 = {0xac96341c4ffffffb, 0x36fc76959f60cd29, 0x666ea36f7879462e, 0x0e0a77c19a07df2f};
+    // 2⁵¹² mod p, used to convert into Montgomery form
+    static constexpr Limbs R2 = {0x1bb8e645ae216da7, 0x53fe3ab1e35c59e3, 0x8c49833d53bb8085, 0x0216d0b17f4e44a5};
+
+    // Multiply-accumulate: returns lo(a + b * c + carry), carry = hi(a + b * c + carry)
+    static constexpr uint64_t mac(uint64_t a, uint64_t b, uint64_t c, uint64_t& carry) {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 t = static_cast<unsigned __int128>(b) * c + a + carry;
+        carry = static_cast<uint64_t>(t >> 64);
+        return static_cast<uint64_t>(t);
+#else
+        uint64_t hi = 0;
+        uint64_t lo = 0;
+        if (std::is_constant_evaluated()) {
+            // Schoolbook on 32-bit halves, _umul128 is not usable in constant expressions
+            const uint64_t b0 = b & 0xffffffff, b1 = b >> 32, c0 = c & 0xffffffff, c1 = c >> 32;
+            const uint64_t p00 = b0 * c0, p01 = b0 * c1, p10 = b1 * c0, p11 = b1 * c1;
+            const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+            lo = (p00 & 0xffffffff) | (mid << 32);
+            hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+        } else {
+            lo = _umul128(b, c, &hi);
+        }
+        lo += a;
+        hi += lo < a;
+        lo += carry;
+        hi += lo < carry;
+        carry = hi;
+        return lo;
+#endif
+    }
+
+    // Add with carry: returns lo(a + b + carry), carry = hi(a + b + carry)
+    static constexpr uint64_t adc(uint64_t a, uint64_t b, uint64_t& carry) {
+        uint64_t s = a + b;
+        uint64_t c = s < a;
+        s += carry;
+        c += s < carry;
+        carry = c;
+        return s;
+    }
+
+    // Subtract with borrow: returns lo(a - b - borrow), borrow = 1 if underflow
+    static constexpr uint64_t sbb(uint64_t a, uint64_t b, uint64_t& borrow) {
+        uint64_t d = a - b;
+        uint64_t c = a < b;
+        c |= d < borrow;
+        d -= borrow;
+        borrow = c;
+        return d;
+    }
+
+    // Subtract p once if a >= p, selected without branching on the value
+    static constexpr void sub_p_if_geq(Limbs& a) {
+        uint64_t borrow = 0;
+        Limbs d = {0, 0, 0, 0};
+        for (size_t i = 0; i < 4; ++i) {
+            d[i] = sbb(a[i], P[i], borrow);
+        }
+        const uint64_t keep = 0 - borrow; // All ones when a < p
+        for (size_t i = 0; i < 4; ++i) {
+            a[i] = (a[i] & keep) | (d[i] & ~keep);
+        }
+    }
+
+    // Montgomery multiplication (CIOS), r = a * b / 2²⁵⁶ mod p
+    // The top limb of p is less than 2⁶² so the intermediate never exceeds 4 limbs
+    static constexpr void mont_mul(Limbs& r, const Limbs& a, const Limbs& b) {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t A = 0;
+            t[0] = mac(t[0], a[0], b[i], A);
+            uint64_t m = t[0] * P_INV_NEG;
+            uint64_t C = 0;
+            mac(t[0], m, P[0], C);
+            for (size_t j = 1; j < 4; ++j) {
+                t[j] = mac(t[j], a[j], b[i], A);
+                t[j - 1] = mac(t[j], m, P[j], C);
+            }
+            t[3] = C + A;
+        }
+        r = {t[0], t[1], t[2], t[3]};
+        sub_p_if_geq(r);
+    }
+
+    static constexpr void mod_add(Limbs& r, const Limbs& a, const Limbs& b) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            r[i] = adc(a[i], b[i], carry);
+        }
+        sub_p_if_geq(r); // a + b < 2p < 2²⁵⁶, no carry out
+    }
+
+    static constexpr void mod_sub(Limbs& r, const Limbs& a, const Limbs& b) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            r[i] = sbb(a[i], b[i], borrow);
+        }
+        const uint64_t mask = 0 - borrow; // Add p back on underflow
+        uint64_t carry = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            r[i] = adc(r[i], P[i] & mask, carry);
+        }
+    }
+
+private:
+    Limbs m_; // Montgomery form, always fully reduced to [0, p)
+};
+
+} // namespace iden3math
@@ -2,10 +2,41 @@
 
 #include <iden3math/macro.h>
 #include <iden3math/typedef.h>
+#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
 
 namespace iden3math::hash {
 
+// Incremental BLAKE-256, update() any number of times then finalize() once, the hasher is reset afterwards
+class API Blake256 final {
+public:
+    static constexpr size_t BLOCK = 64; // Bytes per compression
+
+    Blake256() = default;
+    ~Blake256() = default;
+
+public:
+    void update(std::span<const uint8_t> bytes);
+    void finalize(std::span<uint8_t, 32> digest);
+    [[nodiscard]] std::array<uint8_t, 32> finalize();
+    void reset();
+
+private:
+    static constexpr uint32_t IV[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    uint32_t h_[8] = {IV[0], IV[1], IV[2], IV[3], IV[4], IV[5], IV[6], IV[7]};
+    uint64_t counter_ = 0;      // Message bits compressed so far
+    uint8_t  buffer_[BLOCK] = {}; // Tail shorter than BLOCK not compressed yet
+    size_t   buffered_ = 0;
+};
+
+// Empty input gives an empty digest, Blake256 hashes the empty message
+
 API void blake256(const ByteVec1D& bytes, ByteVec1D& digest);
 
 API ByteVec1D blake256(const ByteVec1D& bytes);
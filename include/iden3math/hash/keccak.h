@@ -2,9 +2,32 @@
 
 #include <iden3math/bigint.h>
 #include <iden3math/macro.h>
+#include <array>
+#include <cstdint>
+#include <span>
 
 namespace iden3math::hash {
 
+// Incremental Keccak256, update() any number of times then finalize() once, the hasher is reset afterwards
+class API Keccak256 final {
+public:
+    static constexpr size_t RATE = 136; // Bytes absorbed per permutation
+
+    Keccak256() = default;
+    ~Keccak256() = default;
+
+public:
+    void update(std::span<const uint8_t> bytes);
+    void finalize(std::span<uint8_t, 32> digest);
+    [[nodiscard]] std::array<uint8_t, 32> finalize();
+    void reset();
+
+private:
+    uint64_t state_[25] = {};
+    uint8_t  buffer_[RATE] = {}; // Tail shorter than RATE not absorbed yet
+    size_t   buffered_ = 0;
+};
+
 // Parameter `bytes` and `digest` are allowed to be the same vector
 API void keccak256(const ByteVec1D& bytes, ByteVec1D& digest);
 
@@ -12,4 +35,14 @@ API void keccak256(const std::string& text, ByteVec1D& digest);
 
 API void keccak256(const BigInt& number, ByteVec1D& digest);
 
+/**
+ * Hash many independent messages, digests[i] = keccak256(inputs[i])
+ * Groups of 8 (AVX-512) or 4 (AVX2) messages run interleaved in SIMD lanes, picked by the CPU at runtime
+ * @param   max_lanes   Upper bound of the lanes per group, 1 forces the scalar code
+ */
+API void keccak256_many(std::span<const std::span<const uint8_t>> inputs, std::span<std::array<uint8_t, 32>> digests, uint32_t max_lanes = 8);
+
+// Lanes keccak256_many() uses on this CPU, 8, 4 or 1
+API uint32_t keccak256_many_lanes();
+
 } // namespace iden3math::hash
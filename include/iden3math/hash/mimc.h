@@ -1,10 +1,31 @@
 #pragma once
 
 #include <iden3math/bigint.h>
+#include <iden3math/fp254.h>
 #include <iden3math/macro.h>
+#include <array>
+#include <cstdint>
+#include <span>
 
 namespace iden3math::hash {
 
 API void mimc_sponge(const ByteVec2D& preimages, size_t outputs, const ByteVec1D& key, ByteVec2D& digests, Endian preimage_endian = BE, Endian key_endian = BE, Endian digest_endian = BE);
 
+/**
+ * Many independent sponges over 32-byte preimages, same result as mimc_sponge() on each group
+ * Sponge i absorbs preimages[i * count, (i + 1) * count) and squeezes digests[i * outputs, (i + 1) * outputs)
+ * Groups of 4 sponges run their Feistel rounds interleaved so the independent multiplications overlap
+ * @param   count     Preimages per sponge, e.g. 2 for (left, right) pairs
+ * @param   threads   Sponges are spread across this many threads
+ */
+API void mimc_sponge_batch(std::span<const std::array<uint8_t, 32>> preimages, size_t count, size_t outputs, const ByteVec1D& key,
+                           std::span<std::array<uint8_t, 32>> digests, Endian preimage_endian = BE, Endian key_endian = BE,
+                           Endian digest_endian = BE, uint32_t threads = 1);
+
+// Two-to-one compression of Merkle trees, mimc_sponge({left, right}, 1, {}) on field elements (circomlib MiMCSponge(2, 220, 1))
+API Fp254 mimc_hash_pair(const Fp254& left, const Fp254& right);
+
+// out[i] = mimc_hash_pair(pairs[2i], pairs[2i + 1]), interleaved like mimc_sponge_batch(), out may not alias pairs
+API void mimc_hash_pairs(std::span<const Fp254> pairs, std::span<Fp254> out);
+
 } // namespace iden3math::hash
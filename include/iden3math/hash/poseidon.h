@@ -0,0 +1,23 @@
+#pragma once
+
+#include <iden3math/fp254.h>
+#include <iden3math/macro.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace iden3math::hash {
+
+static constexpr size_t POSEIDON_MAX_INPUTS = 16;
+
+// circomlib Poseidon(n) of 1 to POSEIDON_MAX_INPUTS inputs, state width n + 1, throws std::invalid_argument otherwise
+API Fp254 poseidon(std::span<const Fp254> inputs);
+
+/**
+ * Many independent hashes of the same arity, digests[i] = poseidon(inputs[i * count, (i + 1) * count))
+ * @param   count     Inputs per hash, 1 to POSEIDON_MAX_INPUTS, inputs.size() must be count * digests.size()
+ * @param   threads   Hashes are spread across this many threads
+ */
+API void poseidon_batch(std::span<const Fp254> inputs, size_t count, std::span<Fp254> digests, uint32_t threads = 1);
+
+} // namespace iden3math::hash
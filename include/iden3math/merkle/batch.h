@@ -0,0 +1,25 @@
+#pragma once
+
+#include <iden3math/fp254.h>
+#include <iden3math/macro.h>
+#include <iden3math/merkle/mapped_tree.h>
+#include <iden3math/merkle/tree.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace iden3math::merkle {
+
+/**
+ * Check many inclusion proofs against one root, result[i] = MerkleTree::compute_root(leaves[i], paths[i]) == root
+ * Level by level, paths that reach the same (left, right) pair share one hash, so the upper levels cost a handful of
+ * hashes instead of one per path. The unique pairs of a level hash interleaved and spread across threads
+ */
+API std::vector<bool> verify_paths_batch(const Fp254& root, std::span<const Fp254> leaves, std::span<const Path> paths, uint32_t threads = 1);
+
+// Paths of many leaves read from the stored levels across threads, throws std::out_of_range before any work for a bad index
+API std::vector<Path> generate_paths_batch(const MerkleTree& tree, std::span<const uint64_t> indices, uint32_t threads = 1);
+
+API std::vector<Path> generate_paths_batch(const MappedMerkleTree& tree, std::span<const uint64_t> indices, uint32_t threads = 1);
+
+} // namespace iden3math::merkle
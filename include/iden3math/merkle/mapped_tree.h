@@ -0,0 +1,68 @@
+#pragma once
+
+#include <iden3math/fp254.h>
+#include <iden3math/macro.h>
+#include <iden3math/merkle/tree.h>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace iden3math::merkle {
+
+/**
+ * Append-only MiMC Merkle tree persisted in a directory, a restarted process serves paths without rehashing
+ *
+ * leaves.log   Header then one record per leaf, 32 big-endian bytes and a checksum of the leaf and its index,
+ *              append-only, the source of truth
+ * nodes.bin    Header then levels 0 to levels of the full tree in level order, memory-mapped, a sparse file holding
+ *              Fp254 in Montgomery form and host byte order
+ *
+ * nodes.bin records how many leaves it reflects. sync() flushes both files, after a crash the tree reopens with the
+ * leaves of the log's intact records, up to the first torn or broken one past the last sync(), and rehashes only the
+ * ones nodes.bin had not recorded yet. A directory is held by one instance at a time, opening it again throws until
+ * the holder is destroyed. POSIX only
+ */
+class API MappedMerkleTree final {
+public:
+    static constexpr uint32_t MAX_LEVELS = 32;
+
+    // Open the tree in dir or create it, levels and zero must match the ones the tree was created with
+    MappedMerkleTree(const std::string& dir, uint32_t levels, const Fp254& zero = Fp254::zero(), uint32_t threads = 1);
+    ~MappedMerkleTree(); // Calls sync()
+    MappedMerkleTree(const MappedMerkleTree&) = delete;
+    MappedMerkleTree& operator=(const MappedMerkleTree&) = delete;
+
+public:
+    // Same as MerkleTree::insert(), the leaves are durable after the next sync()
+    uint64_t insert(const Fp254& leaf);
+    void insert(std::span<const Fp254> leaves, uint32_t threads = 1);
+    // Flush the leaf log and the nodes, then record the leaves the nodes reflect
+    void sync();
+    // Throws std::out_of_range for index >= size()
+    [[nodiscard]] Path path(uint64_t index) const;
+
+public:
+    [[nodiscard]] Fp254        root() const;
+    [[nodiscard]] uint64_t     size() const { return size_; }
+    [[nodiscard]] uint64_t     capacity() const { return uint64_t(1) << levels_; }
+    [[nodiscard]] uint32_t     levels() const { return levels_; }
+    [[nodiscard]] const Fp254& leaf(uint64_t index) const;
+    [[nodiscard]] const Fp254& zero(uint32_t level) const { return zeros_.at(level); }
+
+private:
+    [[nodiscard]] std::span<Fp254> level(uint32_t l) const; // All 2^(levels - l) slots of level l
+    void append_log(std::span<const Fp254> leaves);
+    void replay(uint64_t first, uint32_t threads);
+
+private:
+    uint32_t           levels_;
+    std::vector<Fp254> zeros_;
+    uint64_t           size_ = 0;
+    int                log_fd_ = -1;
+    int                nodes_fd_ = -1;
+    uint8_t*           map_ = nullptr;
+    size_t             map_size_ = 0;
+};
+
+} // namespace iden3math::merkle
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <iden3math/fp254.h>
+#include <iden3math/macro.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace iden3math::merkle {
+
+// Authentication path of one leaf, siblings[0] is next to the leaf and siblings.back() is below the root
+struct Path {
+    uint64_t           index = 0; // Leaf index, bit l tells whether the node at level l is a right child
+    std::vector<Fp254> siblings;
+};
+
+// Append-only binary Merkle tree over hash::mimc_hash_pair(), as Tornado Cash's MerkleTreeWithHistory
+// Unset leaves hold the zero leaf, every level is kept so paths of any leaf can be extracted
+class API MerkleTree final {
+public:
+    static constexpr uint32_t MAX_LEVELS = 32;
+
+    /**
+     * @param   levels    Depth of the tree, it holds 2^levels leaves, 1 to MAX_LEVELS
+     * @param   zero      Value of unset leaves
+     * @param   history   Number of recent roots is_known_root() accepts
+     */
+    explicit MerkleTree(uint32_t levels, const Fp254& zero = Fp254::zero(), size_t history = 30);
+    ~MerkleTree() = default;
+
+public:
+    // Insert at index size() and return that index, O(levels) hashes, throws std::length_error when the tree is full
+    uint64_t insert(const Fp254& leaf);
+    // Append all leaves then rehash the touched nodes level by level bottom-up across threads, one new root in the history
+    void insert(std::span<const Fp254> leaves, uint32_t threads = 1);
+    // Throws std::out_of_range for index >= size()
+    [[nodiscard]] Path path(uint64_t index) const;
+    [[nodiscard]] bool is_known_root(const Fp254& root) const;
+    // Root of the tree that holds leaf where path says, equals root() when the path is valid
+    [[nodiscard]] static Fp254 compute_root(const Fp254& leaf, const Path& path);
+
+public:
+    [[nodiscard]] const Fp254& root() const { return roots_[current_]; }
+    [[nodiscard]] uint64_t     size() const { return nodes_[0].size(); }
+    [[nodiscard]] uint64_t     capacity() const { return uint64_t(1) << levels_; }
+    [[nodiscard]] uint32_t     levels() const { return levels_; }
+    [[nodiscard]] const Fp254& leaf(uint64_t index) const { return nodes_[0].at(index); }
+    [[nodiscard]] const Fp254& zero(uint32_t level) const { return zeros_.at(level); } // Root of an empty subtree of this height
+
+private:
+    std::span<Fp254> level(uint32_t l, uint64_t count); // First count nodes of level l, grown to hold them
+    void push_root(const Fp254& root);
+
+private:
+    uint32_t                        levels_;
+    std::vector<Fp254>              zeros_;    // levels_ + 1 entries
+    std::vector<std::vector<Fp254>> nodes_;    // nodes_[l] are the set nodes of level l, leaves first, the root last
+    size_t                          history_;
+    std::vector<Fp254>              roots_;    // Ring buffer of the last history_ roots, roots_[current_] is the latest
+    size_t                          current_ = 0;
+};
+
+} // namespace iden3math::merkle
@@ -1,63 +1,178 @@
 #include <iden3math/serialize.h>
 #include <iden3math/bigint.h>
 #include <gmpxx.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
 
 namespace iden3math {
 
+static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), "64-bit GMP limbs required");
+
 class BigInt::Impl : public mpz_class {
     using mpz_class::mpz_class;
 };
 
-BigInt::BigInt(int32_t num) : impl_(new Impl(num)) {}
+// Scratch integer reused by every operation in the same thread, results land here before being stored
+class Scratch {
+public:
+    Scratch() { mpz_init2(value_, 512); }
+    ~Scratch() { mpz_clear(value_); }
+    mpz_ptr get() { return value_; }
+private:
+    mpz_t value_;
+};
+
+class BigInt::Storage {
+public:
+    // Read-only view, inline limbs are wrapped in tmp without being copied
+    static mpz_srcptr view(const BigInt& a, mpz_ptr tmp) {
+        if (a.impl_) {
+            return a.impl_->get_mpz_t();
+        }
+        return mpz_roinit_n(tmp, reinterpret_cast<const mp_limb_t*>(a.limbs_), a.size_);
+    }
+
+    static mpz_ptr scratch() {
+        thread_local Scratch s;
+        return s.get();
+    }
+
+    // Store v inline when it fits, the heap is only touched for values wider than INLINE_LIMBS
+    static void assign(BigInt& r, mpz_srcptr v) {
+        const auto n = mpz_size(v);
+        if (n > INLINE_LIMBS) {
+            if (!r.impl_) {
+                r.impl_ = std::make_unique<Impl>();
+            }
+            mpz_set(r.impl_->get_mpz_t(), v);
+            return;
+        }
+        const auto* limbs = mpz_limbs_read(v);
+        for (size_t i = 0; i < INLINE_LIMBS; ++i) {
+            r.limbs_[i] = i < n ? limbs[i] : 0;
+        }
+        r.size_ = mpz_sgn(v) < 0 ? -static_cast<int32_t>(n) : static_cast<int32_t>(n);
+        r.impl_.reset(); // Last, v may be the old heap value
+    }
+
+    template <typename F>
+    static void apply(BigInt& r, const BigInt& a, F f) {
+        mpz_t ta;
+        auto s = scratch();
+        f(s, view(a, ta));
+        assign(r, s);
+    }
+
+    template <typename F>
+    static void apply(BigInt& r, const BigInt& a, const BigInt& b, F f) {
+        mpz_t ta;
+        mpz_t tb;
+        auto s = scratch();
+        f(s, view(a, ta), view(b, tb));
+        assign(r, s);
+    }
 
-BigInt::BigInt(uint32_t num) : impl_(new Impl(num)) {}
+    static int32_t cmp(const BigInt& a, const BigInt& b) {
+        mpz_t ta;
+        mpz_t tb;
+        return mpz_cmp(view(a, ta), view(b, tb));
+    }
 
-BigInt::BigInt(int64_t num) : impl_(new Impl()) {
-    bool sign = num < 0;
-    num = std::abs(num);
-    mpz_import(impl_->get_mpz_t(), 1, -1, sizeof(num), 0, 0, &num);
-    if (sign) {
-        mpz_neg(impl_->get_mpz_t(), impl_->get_mpz_t());
+    static int32_t sgn(const BigInt& a) {
+        mpz_t ta;
+        return mpz_sgn(view(a, ta));
+    }
+};
+
+BigInt::BigInt(int32_t num) : BigInt(static_cast<int64_t>(num)) {}
+
+BigInt::BigInt(uint32_t num) : BigInt(static_cast<uint64_t>(num)) {}
+
+BigInt::BigInt(int64_t num) : BigInt(num < 0 ? 0 - static_cast<uint64_t>(num) : static_cast<uint64_t>(num)) {
+    if (num < 0) {
+        size_ = -size_;
     }
 }
 
 BigInt::BigInt(uint64_t num) {
-    mpz_import(impl_->get_mpz_t(), 1, -1, sizeof(num), 0, 0, &num);
+    limbs_[0] = num;
+    size_ = 0 == num ? 0 : 1;
 }
 
-BigInt::BigInt(const ByteVec1D& bytes, Endian endian) : impl_(new Impl()) {
-    if (bytes.empty()) {
-        *impl_ = 0;
-        return;
+BigInt::BigInt(const ByteVec1D& bytes, Endian endian) : BigInt(from_bytes(bytes, endian)) {}
+
+BigInt BigInt::from_bytes(std::span<const uint8_t> bytes, Endian endian) {
+    BigInt r;
+    if (bytes.size() > INLINE_LIMBS * sizeof(uint64_t)) {
+        auto s = Storage::scratch();
+        mpz_import(s, bytes.size(), endian == BE ? 1 : -1, sizeof(uint8_t), 0, 0, bytes.data());
+        Storage::assign(r, s);
+        return r;
+    }
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        const size_t n = endian == BE ? bytes.size() - 1 - i : i; // Significance of bytes[i]
+        r.limbs_[n / 8] |= static_cast<uint64_t>(bytes[i]) << (n % 8 * 8);
     }
-    mpz_import(impl_->get_mpz_t(), bytes.size(), endian == BE ? 1 : -1, sizeof(uint8_t), 0, 0, bytes.data());
+    r.size_ = INLINE_LIMBS;
+    while (r.size_ > 0 && 0 == r.limbs_[r.size_ - 1]) {
+        --r.size_;
+    }
+    return r;
 }
 
-BigInt::BigInt(const std::string& num, int32_t base) : impl_(new Impl(num, base)) {}
+BigInt::BigInt(const std::string& num, int32_t base) {
+    auto s = Storage::scratch();
+    if (0 != mpz_set_str(s, num.c_str(), base)) {
+        throw std::invalid_argument("mpz_set_str");
+    }
+    Storage::assign(*this, s);
+}
 
-BigInt::BigInt(const Impl& other) : impl_(std::make_unique<Impl>(other)) {}
+BigInt::BigInt(const Impl& other) {
+    Storage::assign(*this, other.get_mpz_t());
+}
 
-BigInt::BigInt(const BigInt& other) {
-    impl_ = std::make_unique<Impl>(*other.impl_);
+BigInt::BigInt(const BigInt& other) : size_(other.size_) {
+    if (other.impl_) {
+        impl_ = std::make_unique<Impl>(*other.impl_);
+    }
+    std::memcpy(limbs_, other.limbs_, sizeof(limbs_));
 }
 
-BigInt::BigInt(BigInt&& other) noexcept {
-    impl_ = std::move(other.impl_);
+BigInt::BigInt(BigInt&& other) noexcept : impl_(std::move(other.impl_)), size_(other.size_) {
+    std::memcpy(limbs_, other.limbs_, sizeof(limbs_));
+    other.size_ = 0;
 }
 
 BigInt::~BigInt() { impl_.reset(); }
 
-bool BigInt::odd() const { return mpz_odd_p(impl_->get_mpz_t()); }
+bool BigInt::odd() const {
+    mpz_t t;
+    return mpz_odd_p(Storage::view(*this, t));
+}
 
-bool BigInt::even() const { return mpz_even_p(impl_->get_mpz_t()); }
+bool BigInt::even() const {
+    mpz_t t;
+    return mpz_even_p(Storage::view(*this, t));
+}
 
-std::string BigInt::str(uint8_t base) const { return impl_->get_str(base); }
+std::string BigInt::str(uint8_t base) const {
+    mpz_t t;
+    auto v = Storage::view(*this, t);
+    std::string s(mpz_sizeinbase(v, base) + 2, '\0'); // Sign and terminator
+    mpz_get_str(s.data(), base, v);
+    s.resize(std::strlen(s.c_str()));
+    return s;
+}
 
 uint32_t BigInt::unsigned_int() const {
-    if (*impl_ > UINT32_MAX) {
+    mpz_t t;
+    auto v = Storage::view(*this, t);
+    if (mpz_cmp_ui(v, UINT32_MAX) > 0) {
         throw std::out_of_range("BigInt is too large to fit in a uint32_t");
     }
-    return impl_->get_ui();
+    return mpz_get_ui(v);
 }
 
 BitVec1D BigInt::bits(Endian endian) const {
@@ -65,15 +180,51 @@ BitVec1D BigInt::bits(Endian endian) const {
 }
 
 ByteVec1D BigInt::bytes(Endian endian) const {
+    mpz_t t;
     ByteVec1D out(bytes_size());
     size_t len = 0;
-    mpz_export(out.data(), &len, endian == BE ? 1 : -1, sizeof(uint8_t), 0, 0, impl_->get_mpz_t());
+    mpz_export(out.data(), &len, endian == BE ? 1 : -1, sizeof(uint8_t), 0, 0, Storage::view(*this, t));
     out.resize(len);
     return out;
 }
 
+void BigInt::to_bytes_fixed(std::span<uint8_t> out, Endian endian) const {
+    if (!impl_) {
+        // Inline magnitude, written byte by byte from the limbs
+        const size_t n = std::abs(size_) * sizeof(uint64_t);
+        for (size_t i = out.size(); i < n; ++i) {
+            if (0 != static_cast<uint8_t>(limbs_[i / 8] >> (i % 8 * 8))) {
+                throw std::out_of_range("BigInt is too large to fit in the output bytes");
+            }
+        }
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[endian == BE ? out.size() - 1 - i : i] = i < n ? static_cast<uint8_t>(limbs_[i / 8] >> (i % 8 * 8)) : 0;
+        }
+        return;
+    }
+    mpz_t t;
+    auto v = Storage::view(*this, t);
+    const auto len = (mpz_sizeinbase(v, 2) + 7) / 8;
+    if (0 == mpz_sgn(v)) {
+        std::memset(out.data(), 0, out.size());
+        return;
+    }
+    if (len > out.size()) {
+        throw std::out_of_range("BigInt is too large to fit in the output bytes");
+    }
+    const auto padding = out.size() - len;
+    if (endian == BE) {
+        std::memset(out.data(), 0, padding);
+        mpz_export(out.data() + padding, nullptr, 1, sizeof(uint8_t), 0, 0, v);
+    } else {
+        mpz_export(out.data(), nullptr, -1, sizeof(uint8_t), 0, 0, v);
+        std::memset(out.data() + len, 0, padding);
+    }
+}
+
 size_t BigInt::bits_size() const {
-    return mpz_sizeinbase(impl_->get_mpz_t(), 2);
+    mpz_t t;
+    return mpz_sizeinbase(Storage::view(*this, t), 2);
 }
 
 size_t BigInt::bytes_size() const {
@@ -82,71 +233,112 @@ size_t BigInt::bytes_size() const {
 
 BigInt BigInt::pow(const uint32_t& exp) const {
     BigInt r;
-    mpz_pow_ui(r.impl_->get_mpz_t(), impl_->get_mpz_t(), exp);
+    Storage::apply(r, *this, [exp](mpz_ptr s, mpz_srcptr a) { mpz_pow_ui(s, a, exp); });
     return r;
 }
 
 BigInt BigInt::pow_mod(const BigInt& exp, const BigInt& modulo) const {
     BigInt r;
-    mpz_powm(r.impl_->get_mpz_t(), impl_->get_mpz_t(), exp.impl_->get_mpz_t(), modulo.impl_->get_mpz_t());
+    powm(r, *this, exp, modulo);
     return r;
 }
 
 std::optional<BigInt> BigInt::mod_inv(const BigInt& modulo) const {
-    Impl inv;
-    if (0 == mpz_invert(inv.get_mpz_t(), impl_->get_mpz_t(), modulo.impl_->get_mpz_t())) {
+    mpz_t t;
+    auto m = Storage::view(modulo, t);
+    bool invertible = false;
+    BigInt r;
+    Storage::apply(r, *this, [m, &invertible](mpz_ptr s, mpz_srcptr a) { invertible = 0 != mpz_invert(s, a, m); });
+    if (!invertible) {
         return std::nullopt;
     }
-    return inv;
+    return r;
+}
+
+void BigInt::add(BigInt& out, const BigInt& a, const BigInt& b) {
+    Storage::apply(out, a, b, mpz_add);
+}
+
+void BigInt::sub(BigInt& out, const BigInt& a, const BigInt& b) {
+    Storage::apply(out, a, b, mpz_sub);
+}
+
+void BigInt::mul(BigInt& out, const BigInt& a, const BigInt& b) {
+    Storage::apply(out, a, b, mpz_mul);
+}
+
+void BigInt::mod(BigInt& out, const BigInt& a, const BigInt& b) {
+    Storage::apply(out, a, b, mpz_tdiv_r);
+}
+
+void BigInt::powm(BigInt& out, const BigInt& base, const BigInt& exp, const BigInt& modulo) {
+    mpz_t t;
+    auto m = Storage::view(modulo, t);
+    Storage::apply(out, base, exp, [m](mpz_ptr s, mpz_srcptr a, mpz_srcptr e) { mpz_powm(s, a, e, m); });
 }
 
 BigInt& BigInt::operator=(const BigInt& other) {
-    if (this != &other) {
-        impl_ = std::make_unique<Impl>(*other.impl_);
+    if (this == &other) {
+        return *this;
     }
+    if (other.impl_) {
+        if (impl_) {
+            *impl_ = *other.impl_;
+        } else {
+            impl_ = std::make_unique<Impl>(*other.impl_);
+        }
+    } else {
+        impl_.reset();
+    }
+    size_ = other.size_;
+    std::memcpy(limbs_, other.limbs_, sizeof(limbs_));
     return *this;
 }
 
 BigInt& BigInt::operator=(BigInt&& other) noexcept {
     if (this != &other) {
         impl_ = std::move(other.impl_);
+        size_ = other.size_;
+        std::memcpy(limbs_, other.limbs_, sizeof(limbs_));
+        other.size_ = 0;
     }
     return *this;
 }
 
-#define BIGINT_OP_IMPL_ARITHMETIC_BITWISE(op) \
-    BigInt BigInt::operator op(const BigInt& rhs) const { return {*impl_ op *rhs.impl_}; } \
-    BigInt BigInt::operator op(int32_t rhs) const { return {*impl_ op rhs}; } \
-    BigInt BigInt::operator op(uint32_t rhs) const { return {*impl_ op rhs}; } \
-    BigInt BigInt::operator op(int64_t rhs) const { return {*this op BigInt(rhs)}; } \
-    BigInt BigInt::operator op(uint64_t rhs) const { return {*this op BigInt(rhs)}; } \
-    void BigInt::operator op##=(const BigInt& rhs) { *impl_ op##= *rhs.impl_; } \
-    void BigInt::operator op##=(int32_t rhs) { *impl_ op##= rhs; } \
-    void BigInt::operator op##=(uint32_t rhs) { *impl_ op##= rhs; } \
+#define BIGINT_OP_IMPL_ARITHMETIC_BITWISE(op, fn) \
+    BigInt BigInt::operator op(const BigInt& rhs) const { BigInt r; Storage::apply(r, *this, rhs, fn); return r; } \
+    BigInt BigInt::operator op(int32_t rhs) const { return *this op BigInt(rhs); } \
+    BigInt BigInt::operator op(uint32_t rhs) const { return *this op BigInt(rhs); } \
+    BigInt BigInt::operator op(int64_t rhs) const { return *this op BigInt(rhs); } \
+    BigInt BigInt::operator op(uint64_t rhs) const { return *this op BigInt(rhs); } \
+    void BigInt::operator op##=(const BigInt& rhs) { Storage::apply(*this, *this, rhs, fn); } \
+    void BigInt::operator op##=(int32_t rhs) { *this op##= BigInt(rhs); } \
+    void BigInt::operator op##=(uint32_t rhs) { *this op##= BigInt(rhs); } \
     void BigInt::operator op##=(int64_t rhs) { *this op##= BigInt(rhs); } \
     void BigInt::operator op##=(uint64_t rhs) { *this op##= BigInt(rhs); }
 
-#define BIGINT_OP_IMPL_BIT_SHIFT(op) \
-    BigInt BigInt::operator op(uint32_t rhs) const { return {mpz_class(*impl_) op rhs}; } \
-    void BigInt::operator op##=(uint32_t rhs) { *impl_ op##= rhs; }
+#define BIGINT_OP_IMPL_BIT_SHIFT(op, fn) \
+    BigInt BigInt::operator op(uint32_t rhs) const { BigInt r; Storage::apply(r, *this, [rhs](mpz_ptr s, mpz_srcptr a) { fn(s, a, rhs); }); return r; } \
+    void BigInt::operator op##=(uint32_t rhs) { Storage::apply(*this, *this, [rhs](mpz_ptr s, mpz_srcptr a) { fn(s, a, rhs); }); }
 
 #define BIGINT_OP_IMPL_LOGIC(op) \
-    bool BigInt::operator op(const BigInt& rhs) const { return *impl_ op *rhs.impl_; } \
-    bool BigInt::operator op(int32_t rhs) const { return *impl_ op rhs; } \
-    bool BigInt::operator op(uint32_t rhs) const { return *impl_ op rhs; } \
+    bool BigInt::operator op(const BigInt& rhs) const { return Storage::cmp(*this, rhs) op 0; } \
+    bool BigInt::operator op(int32_t rhs) const { return *this op BigInt(rhs); } \
+    bool BigInt::operator op(uint32_t rhs) const { return *this op BigInt(rhs); } \
     bool BigInt::operator op(int64_t rhs) const { return *this op BigInt(rhs); } \
     bool BigInt::operator op(uint64_t rhs) const { return *this op BigInt(rhs); }
 
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(+)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(-)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(*)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(/)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(%)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(&)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(|)
-BIGINT_OP_IMPL_ARITHMETIC_BITWISE(^)
-BIGINT_OP_IMPL_BIT_SHIFT(<<)
-BIGINT_OP_IMPL_BIT_SHIFT(>>)
+// Division and remainder truncate toward zero, as mpz_class does
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(+, mpz_add)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(-, mpz_sub)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(*, mpz_mul)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(/, mpz_tdiv_q)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(%, mpz_tdiv_r)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(&, mpz_and)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(|, mpz_ior)
+BIGINT_OP_IMPL_ARITHMETIC_BITWISE(^, mpz_xor)
+BIGINT_OP_IMPL_BIT_SHIFT(<<, mpz_mul_2exp)
+BIGINT_OP_IMPL_BIT_SHIFT(>>, mpz_fdiv_q_2exp)
 BIGINT_OP_IMPL_LOGIC(==)
 BIGINT_OP_IMPL_LOGIC(!=)
 BIGINT_OP_IMPL_LOGIC(<)
@@ -155,35 +347,43 @@ BIGINT_OP_IMPL_LOGIC(<=)
 BIGINT_OP_IMPL_LOGIC(>=)
 
 BigInt& BigInt::operator++() {
-    ++(*impl_);
+    Storage::apply(*this, *this, [](mpz_ptr s, mpz_srcptr a) { mpz_add_ui(s, a, 1); });
     return *this;
 }
 
-BigInt BigInt::operator++(int) const {
+BigInt BigInt::operator++(int) {
     BigInt temp(*this);
-    ++(*impl_);
+    ++*this;
     return temp;
 }
 
 BigInt& BigInt::operator--() {
-    --(*impl_);
+    Storage::apply(*this, *this, [](mpz_ptr s, mpz_srcptr a) { mpz_sub_ui(s, a, 1); });
     return *this;
 }
 
-BigInt BigInt::operator--(int) const {
+BigInt BigInt::operator--(int) {
     BigInt temp(*this);
-    --(*impl_);
+    --*this;
     return temp;
 }
 
 BigInt BigInt::operator+() const { return *this; }
 
-BigInt BigInt::operator-() const { return {-*impl_}; }
+BigInt BigInt::operator-() const {
+    BigInt r;
+    Storage::apply(r, *this, mpz_neg);
+    return r;
+}
 
-BigInt BigInt::operator~() const { return {~*impl_}; }
+BigInt BigInt::operator~() const {
+    BigInt r;
+    Storage::apply(r, *this, mpz_com);
+    return r;
+}
 
-bool BigInt::operator!() const { return 0 == *impl_; }
+bool BigInt::operator!() const { return 0 == Storage::sgn(*this); }
 
-BigInt::operator bool() const { return 0 != *impl_; }
+BigInt::operator bool() const { return 0 != Storage::sgn(*this); }
 
 } // namespace iden3math
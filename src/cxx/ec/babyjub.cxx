@@ -1,6 +1,12 @@
 #include <iden3math/ec/babyjub.h>
+#include <iden3math/fp254.h>
 #include <iden3math/prime.h>
-#include <iden3math/serialize.h>
+#include "cxx/parallel.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 namespace iden3math::ec::babyjub {
 
@@ -8,9 +14,21 @@ inline bool non_regulated_x(const BigInt& x) {
     return x > (prime::bn254() - 1) / 2;
 }
 
-static const BigInt A("168700", 10);
+inline bool non_regulated_x(const Fp254& x) {
+    // (p - 1) / 2
+    static constexpr Fp254::Limbs HALF = {0xa1f0fac9f8000000, 0x9419f4243cdcb848, 0xdc2822db40c0ac2e, 0x183227397098d014};
+    const auto l = x.limbs();
+    for (size_t i = 4; i-- > 0;) {
+        if (l[i] != HALF[i]) {
+            return l[i] > HALF[i];
+        }
+    }
+    return false;
+}
+
+static constexpr Fp254 A(168700);
 
-static const BigInt D("168696", 10);
+static constexpr Fp254 D(168696);
 
 const BigInt& prime() { return prime::bn254(); }
 
@@ -42,66 +60,345 @@ const Point& generator() {
     return GENERATOR;
 }
 
-inline const Fp1& f() { // Shorter name for convenience
-    return finite_field();
+static bool in_curve(const Fp254& x, const Fp254& y) {
+    auto x2 = x.square();
+    auto y2 = y.square();
+    auto lhs = A * x2 + y2; // A * x² + y²
+    auto rhs = Fp254::one() + D * x2 * y2; // 1 + D * x² * y²
+    return lhs == rhs;
 }
 
-Point add(const Point& a, const Point& b) {
-    Point r;
-    auto beta = f().mul(a.x, b.y);
-    auto gamma = f().mul(a.y, b.x);
-    auto delta = f().mul(
-        f().sub(a.y, f().mul(A, a.x)),
-        f().add(b.x, b.y)
-    );
-    auto tau = f().mul(beta, gamma);
-    auto dtau = f().mul(D, tau);
-    r.x = *f().div(
-        f().add(beta, gamma),
-        f().add(1, dtau)
-    );
-    r.y = *f().div(
-        f().add(delta, f().sub(f().mul(A, beta), gamma)),
-        f().sub(1, dtau)
-    );
+inline bool is_zero(const PointExt& p) {
+    return p.x.is_zero() && p.y == p.z;
+}
+
+PointExt to_ext(const Point& p) {
+    Fp254 x(p.x);
+    Fp254 y(p.y);
+    return {x, y, x * y, Fp254::one()};
+}
+
+Point to_affine(const PointExt& p) {
+    auto inv_z = p.z.inv();
+    return Point((p.x * inv_z).big_int(), (p.y * inv_z).big_int());
+}
+
+std::vector<Point> normalize_batch(std::span<const PointExt> points) {
+    std::vector<Fp254> inv_z(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        inv_z[i] = points[i].z;
+    }
+    Fp254::batch_inv(inv_z);
+    std::vector<Point> r;
+    r.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        r.emplace_back((points[i].x * inv_z[i]).big_int(), (points[i].y * inv_z[i]).big_int());
+    }
     return r;
 }
 
-Point mul_scalar(const Point& p, const BigInt& k) {
-    Point r;
-    r.x = 0;
-    r.y = 1;
-    BigInt rem = k;
-    Point exp = p;
-    while (0 != rem) {
-        if (rem.odd()) {
-            r = add(r, exp);
-        }
-        exp = add(exp, exp);
-        rem >>= 1;
+// add-2008-hwcd, complete on BabyJubjub because A is a square and D is not
+constexpr PointExt hwcd_add(const PointExt& a, const PointExt& b) {
+    auto aa = a.x * b.x;
+    auto bb = a.y * b.y;
+    auto cc = D * a.t * b.t;
+    auto dd = a.z * b.z;
+    auto e = (a.x + a.y) * (b.x + b.y) - aa - bb;
+    auto f = dd - cc;
+    auto g = dd + cc;
+    auto h = bb - A * aa;
+    return {e * f, g * h, e * h, f * g};
+}
+
+// dbl-2008-hwcd
+constexpr PointExt hwcd_dbl(const PointExt& p) {
+    auto aa = p.x.square();
+    auto bb = p.y.square();
+    auto cc = p.z.square().dbl();
+    auto dd = A * aa;
+    auto e = (p.x + p.y).square() - aa - bb;
+    auto g = dd + bb;
+    auto f = g - cc;
+    auto h = dd - bb;
+    return {e * f, g * h, e * h, f * g};
+}
+
+PointExt add(const PointExt& a, const PointExt& b) {
+    return hwcd_add(a, b);
+}
+
+PointExt dbl(const PointExt& p) {
+    return hwcd_dbl(p);
+}
+
+// Fixed-base table for generator(), BASE_TABLE[i][j] = (j + 1) * 16 ^ i * G
+// mul_base() adds one entry per 4-bit window of the scalar, 64 additions and no doubling
+typedef std::array<std::array<PointExt, 15>, 64> BaseTable;
+
+constexpr void build_base_table(BaseTable& table, const PointExt& g) {
+    auto base = g;
+    for (auto& row : table) {
+        row[0] = base;
+        for (size_t j = 1; j < row.size(); ++j) {
+            row[j] = hwcd_add(row[j - 1], base);
+        }
+        base = hwcd_add(row[row.size() - 1], base);
+    }
+}
+
+#ifdef IDEN3MATH_CONSTEXPR_TABLES
+static constexpr BaseTable BASE_TABLE = [] {
+    constexpr auto x = Fp254::from_limbs({0x40f41a59f4d4b45e, 0xb494b1255b1162bb, 0x38bcba38f25645ad, 0x023343e3445b673d});
+    constexpr auto y = Fp254::from_limbs({0x50f87d64fc000001, 0x4a0cfa121e6e5c24, 0x6e14116da0605617, 0x0c19139cb84c680a});
+    BaseTable table;
+    build_base_table(table, {x, y, x * y, Fp254::one()});
+    return table;
+}();
+
+inline const BaseTable& base_table() {
+    return BASE_TABLE;
+}
+#else
+// Built on first use, the static initialization is thread-safe and the table is read-only afterwards
+static const BaseTable& base_table() {
+    static const auto TABLE = [] {
+        auto table = std::make_unique<BaseTable>();
+        build_base_table(*table, to_ext(generator()));
+        return table;
+    }();
+    return *TABLE;
+}
+#endif
+
+inline PointExt neg(const PointExt& p) {
+    return {-p.x, p.y, -p.t, p.z};
+}
+
+inline void cswap(PointExt& a, PointExt& b, bool swap) {
+    Fp254::cswap(a.x, b.x, swap);
+    Fp254::cswap(a.y, b.y, swap);
+    Fp254::cswap(a.t, b.t, swap);
+    Fp254::cswap(a.z, b.z, swap);
+}
+
+// Read count (<= 8) bits of a little-endian magnitude starting at pos, bits beyond the end are zero
+inline uint32_t get_bits(const ByteVec1D& le, size_t pos, uint32_t count) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        auto bit = pos + i;
+        if (bit / 8 < le.size()) {
+            r |= static_cast<uint32_t>((le[bit / 8] >> (bit % 8)) & 1) << i;
+        }
+    }
+    return r;
+}
+
+// Width-w non-adjacent form, every non-zero digit is odd and |digit| < 2 ^ (w - 1)
+static std::vector<int32_t> wnaf(const ByteVec1D& le, uint32_t width) {
+    const size_t len = le.size() * 8 + width; // Room for the final carry
+    std::vector<int32_t> digits(len, 0);
+    uint32_t carry = 0;
+    size_t bit = 0;
+    while (bit < len) {
+        if (get_bits(le, bit, 1) == carry) {
+            ++bit;
+            continue;
+        }
+        auto word = static_cast<int32_t>(get_bits(le, bit, width) + carry);
+        carry = (word >> (width - 1)) & 1;
+        word -= static_cast<int32_t>(carry << width);
+        digits[bit] = word;
+        bit += width;
+    }
+    return digits;
+}
+
+PointExt mul_scalar(const PointExt& p, const BigInt& k) {
+    return mul_scalar_wnaf(p, k);
+}
+
+PointExt mul_scalar_wnaf(const PointExt& p, const BigInt& k, uint32_t width) {
+    if (width < 2 || width > 8) {
+        throw std::invalid_argument("wNAF width must be in [2, 8]");
+    }
+    // Odd multiples P, 3P, 5P, ..., (2 ^ (w - 1) - 1)P
+    const auto base = k < 0 ? neg(p) : p;
+    std::array<PointExt, 64> table;
+    const size_t table_size = size_t(1) << (width - 2);
+    table[0] = base;
+    if (table_size > 1) {
+        const auto base2 = dbl(base);
+        for (size_t i = 1; i < table_size; ++i) {
+            table[i] = add(table[i - 1], base2);
+        }
+    }
+    const auto digits = wnaf(k.bytes(LE), width); // Magnitude of k
+    PointExt r;
+    bool started = false;
+    for (size_t i = digits.size(); i-- > 0;) {
+        if (started) {
+            r = dbl(r);
+        }
+        const auto d = digits[i];
+        if (d > 0) {
+            r = started ? add(r, table[d / 2]) : table[d / 2];
+            started = true;
+        } else if (d < 0) {
+            r = started ? add(r, neg(table[-d / 2])) : neg(table[-d / 2]);
+            started = true;
+        }
     }
     return r;
 }
 
+// e = k mod group_order() in [0, group_order()), written into the caller's storage
+inline void reduce_scalar(BigInt& e, const BigInt& k) {
+    BigInt::mod(e, k, group_order());
+    if (e < 0) {
+        BigInt::add(e, e, group_order());
+    }
+}
+
+// Montgomery ladder, one doubling and one addition per bit regardless of the scalar value
+PointExt mul_scalar_ct(const PointExt& p, const BigInt& k) {
+    BigInt e;
+    reduce_scalar(e, k);
+    auto le = e.bytes(LE);
+    le.resize(32, 0);
+    PointExt r0;
+    PointExt r1 = p;
+    for (size_t i = 256; i-- > 0;) {
+        const bool bit = (le[i / 8] >> (i % 8)) & 1;
+        cswap(r0, r1, bit);
+        r1 = add(r0, r1);
+        r0 = dbl(r0);
+        cswap(r0, r1, bit);
+    }
+    return r0;
+}
+
+Point add(const Point& a, const Point& b) {
+    return to_affine(add(to_ext(a), to_ext(b)));
+}
+
+Point mul_scalar(const Point& p, const BigInt& k) {
+    return to_affine(mul_scalar(to_ext(p), k));
+}
+
+Point mul_scalar_wnaf(const Point& p, const BigInt& k, uint32_t width) {
+    return to_affine(mul_scalar_wnaf(to_ext(p), k, width));
+}
+
+Point mul_scalar_ct(const Point& p, const BigInt& k) {
+    return to_affine(mul_scalar_ct(to_ext(p), k));
+}
+
+Point mul_base(const BigInt& k) {
+    BigInt e;
+    reduce_scalar(e, k);
+    auto le = e.bytes(LE);
+    const auto& table = base_table();
+    PointExt r;
+    for (size_t i = 0; i < le.size() * 2; ++i) {
+        const auto nibble = (le[i / 2] >> (i % 2 * 4)) & 0x0f;
+        if (0 != nibble) {
+            r = hwcd_add(r, table[i][nibble - 1]);
+        }
+    }
+    return to_affine(r);
+}
+
+// Window size of bucket-based Pippenger, roughly ln(n) + 2 bits
+inline uint32_t msm_window(size_t n) {
+    if (n < 32) {
+        return 3;
+    }
+    uint32_t log2 = 0;
+    while ((size_t(1) << (log2 + 1)) <= n) {
+        ++log2;
+    }
+    return std::min<uint32_t>(log2 * 69 / 100 + 2, 16);
+}
+
+// Read c (<= 16) bits starting at pos from a little-endian magnitude of len bytes
+inline uint32_t get_window(const Byte* le, size_t len, size_t pos, uint32_t c) {
+    uint32_t v = 0;
+    const auto byte = pos / 8;
+    for (size_t i = 0; i < 3 && byte + i < len; ++i) {
+        v |= static_cast<uint32_t>(le[byte + i]) << (i * 8);
+    }
+    return (v >> (pos % 8)) & ((uint32_t(1) << c) - 1);
+}
+
+Point msm(std::span<const Point> points, std::span<const BigInt> scalars, uint32_t threads) {
+    if (points.size() != scalars.size()) {
+        throw std::invalid_argument("Number of points and scalars mismatch");
+    }
+    const auto n = points.size();
+    // Magnitudes in a flat little-endian buffer, the sign is moved onto the point
+    size_t stride = 1;
+    for (const auto& k : scalars) {
+        stride = std::max(stride, k.bytes_size());
+    }
+    std::vector<Byte> digits(n * stride, 0);
+    std::vector<PointExt> bases(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto le = scalars[i].bytes(LE);
+        std::copy(le.begin(), le.end(), digits.begin() + static_cast<std::ptrdiff_t>(i * stride));
+        bases[i] = to_ext(points[i]);
+        if (scalars[i] < 0) {
+            bases[i] = neg(bases[i]);
+        }
+    }
+    const auto c = msm_window(n);
+    const auto windows = (stride * 8 + c - 1) / c;
+    std::vector<PointExt> window_sums(windows);
+    auto job = [&](size_t first, size_t last) {
+        std::vector<PointExt> buckets(size_t(1) << c);
+        for (size_t w = first; w < last; ++w) {
+            std::fill(buckets.begin(), buckets.end(), PointExt());
+            for (size_t i = 0; i < n; ++i) {
+                const auto d = get_window(&digits[i * stride], stride, w * c, c);
+                if (0 != d) {
+                    buckets[d] = hwcd_add(buckets[d], bases[i]);
+                }
+            }
+            // Sum of d * buckets[d] by running sums, 2 * (2 ^ c) additions
+            PointExt running;
+            PointExt sum;
+            for (size_t d = buckets.size() - 1; d > 0; --d) {
+                running = hwcd_add(running, buckets[d]);
+                sum = hwcd_add(sum, running);
+            }
+            window_sums[w] = sum;
+        }
+    };
+    parallel_for(windows, threads, job);
+    // Horner over the windows from the most significant one
+    PointExt r;
+    for (size_t w = windows; w-- > 0;) {
+        for (uint32_t i = 0; i < c; ++i) {
+            r = hwcd_dbl(r);
+        }
+        r = hwcd_add(r, window_sums[w]);
+    }
+    return to_affine(r);
+}
+
 bool in_sub_group(const Point& p) {
     if (!in_curve(p)) {
         return false;
     }
-    auto r = mul_scalar(p, sub_group_order());
-    return 0 == r.x && 1 == r.y;
+    return is_zero(mul_scalar(to_ext(p), sub_group_order()));
 }
 
 bool in_curve(const Point& p) {
-    auto x2 = *f().pow(p.x, 2); // Always not std::nullopt because exp is 2 >= 0
-    auto y2 = *f().pow(p.y, 2); // Always not std::nullopt because exp is 2 >= 0
-    auto lhs = f().add(f().mul(A, x2), y2); // A * x² + y²
-    auto rhs =  f().add(1, f().mul(f().mul(x2, y2), D)); // 1 + D * x² * y²
-    return lhs == rhs;
+    return in_curve(Fp254(p.x), Fp254(p.y));
 }
 
 ByteVec1D compress(const Point& p, Endian endian) {
-    auto bytes = p.y.bytes(endian);
-    serialize::pad(bytes, 0x00, 32 - bytes.size(), BE == endian);;
+    ByteVec1D bytes(32);
+    p.y.to_bytes_fixed(bytes, endian);
     if (non_regulated_x(p.x)) {
         auto& sign_byte = LE == endian ? bytes.back() : bytes.front();
         sign_byte |= 0x80;
@@ -109,36 +406,111 @@ ByteVec1D compress(const Point& p, Endian endian) {
     return bytes;
 }
 
-std::optional<Point> decompress(ByteVec1D packed, Endian endian) {
+std::vector<ByteVec1D> compress_batch(std::span<const PointExt> points, Endian endian) {
+    std::vector<Fp254> inv_z(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        inv_z[i] = points[i].z;
+    }
+    Fp254::batch_inv(inv_z);
+    std::vector<ByteVec1D> r;
+    r.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto x = points[i].x * inv_z[i];
+        const auto y = (points[i].y * inv_z[i]).limbs();
+        ByteVec1D bytes(32);
+        for (size_t j = 0; j < bytes.size(); ++j) {
+            bytes[j] = static_cast<Byte>(y[j / 8] >> (j % 8 * 8));
+        }
+        if (non_regulated_x(x)) {
+            bytes.back() |= 0x80;
+        }
+        if (BE == endian) {
+            std::reverse(bytes.begin(), bytes.end());
+        }
+        r.emplace_back(std::move(bytes));
+    }
+    return r;
+}
+
+std::optional<Point> decompress(const ByteVec1D& bytes, Endian endian) {
+    auto packed = bytes;
     auto& sign_byte = LE == endian ? packed.back() : packed.front();
     const bool sign = (sign_byte & 0x80) >> 7;
     if (sign) {
         sign_byte &= 0x7f;
     }
-    auto num = BigInt(packed, endian);
+    auto num = BigInt::from_bytes(packed, endian);
     if (num >= prime::bn254()) {
         return std::nullopt;
     }
-    Point P;
-    P.y = num;
-    auto y2 = f().square(P.y);
-    auto x = f().sqrt(
-        *f().div(
-            f().sub(1, y2),
-            f().sub(A, f().mul(D, y2))
-        )
-    );
+    Fp254 y(num);
+    auto y2 = y.square();
+    auto x = ((Fp254::one() - y2) * (A - D * y2).inv()).sqrt();
     if (std::nullopt == x) {
         return std::nullopt;
     }
-    if (sign != non_regulated_x(*x)) {
-        x = f().neg(*x);
+    if (sign != non_regulated_x(x->big_int())) {
+        x = -*x;
     }
-    P.x = *x;
-    if (!in_curve(P)) {
+    if (!in_curve(*x, y)) {
         return std::nullopt;
     }
-    return P;
+    return Point(x->big_int(), num);
+}
+
+// Decompress [begin, end) sharing one inversion for all the denominators A - D * y²
+static void decompress_range(std::span<const std::array<uint8_t, 32>> packed, Endian endian, std::span<std::optional<Point>> out) {
+    const auto& p = Fp254::modulus();
+    std::vector<Fp254> ys(packed.size());
+    std::vector<Fp254> dens(packed.size());
+    std::vector<bool> signs(packed.size());
+    std::vector<bool> valid(packed.size());
+    for (size_t i = 0; i < packed.size(); ++i) {
+        Fp254::Limbs y = {0, 0, 0, 0};
+        for (size_t j = 0; j < 32; ++j) {
+            y[j / 8] |= static_cast<uint64_t>(packed[i][LE == endian ? j : 31 - j]) << (j % 8 * 8);
+        }
+        signs[i] = y[3] >> 63;
+        y[3] &= 0x7fffffffffffffff;
+        // Reject non-canonical y >= p
+        valid[i] = false;
+        for (size_t j = 4; j-- > 0;) {
+            if (y[j] != p[j]) {
+                valid[i] = y[j] < p[j];
+                break;
+            }
+        }
+        if (valid[i]) {
+            ys[i] = Fp254::from_limbs(y);
+            dens[i] = A - D * ys[i].square();
+        }
+    }
+    Fp254::batch_inv(dens);
+    for (size_t i = 0; i < packed.size(); ++i) {
+        out[i] = std::nullopt;
+        if (!valid[i]) {
+            continue;
+        }
+        auto x = ((Fp254::one() - ys[i].square()) * dens[i]).sqrt();
+        if (std::nullopt == x) {
+            continue;
+        }
+        if (signs[i] != non_regulated_x(*x)) {
+            x = -*x;
+        }
+        if (!in_curve(*x, ys[i])) {
+            continue;
+        }
+        out[i] = Point(x->big_int(), ys[i].big_int());
+    }
+}
+
+std::vector<std::optional<Point>> decompress_batch(std::span<const std::array<uint8_t, 32>> packed, Endian endian, uint32_t threads) {
+    std::vector<std::optional<Point>> out(packed.size());
+    parallel_for(packed.size(), threads, [&](size_t first, size_t last) {
+        decompress_range(packed.subspan(first, last - first), endian, std::span(out).subspan(first, last - first));
+    });
+    return out;
 }
 
 } // namespace iden3math::ec::babyjub
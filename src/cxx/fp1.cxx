@@ -1,37 +1,72 @@
 #include <iden3math/fp1.h>
-#include <iden3math/random.h>
+#include <iden3math/fp254.h>
+#include <iden3math/prime.h>
 #include <cassert>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <utility>
+#include <vector>
 #include <gmpxx.h>
 
 namespace iden3math {
 
-Fp1::Fp1(BigInt prime)
-    : p_(std::move(prime))
-    , m_(1)
-{
-    // Tonelli–Shanks square root
-    assert(p_.odd()); // Prime must be odd
-    BigInt tmp = p_.pow(m_);
-    // Init: q_ = p_ ^ m_ - 1
-    q_ = tmp - 1;
-    s_ = 0;
-    while (q_.even()) {
-        s_ += 1;
-        q_ /= 2;
-    }
-    // Final: q_ = (p_ ^ m_ - 1) / (2 ^ s_)
-    q_m1_d2_ = (q_ - 1) / 2;
-    auto two_pow_s_m1 = BigInt(2).pow(s_ - 1);
-    // Find a z_ satisfy z_ / p_ = -1
-    BigInt c0 = 1;
-    while (1 == c0) {
-        BigInt rand = random::get_integer(p_);
-        z_ = rand.pow_mod(q_, p_); // z_ = rand ^ q_
-        c0 = z_.pow_mod(two_pow_s_m1, p_); // c0 = z_ ^ (2 ^ (s_ - 1))
+static std::shared_ptr<const FieldContext> make_context(const BigInt& p) {
+    assert(p.odd()); // Prime must be odd
+    auto ctx = std::make_shared<FieldContext>();
+    ctx->p = p;
+    ctx->p_m1_d2 = (p - 1) / 2;
+    // Tonelli–Shanks square root, p - 1 = q * (2 ^ s)
+    ctx->q = p - 1;
+    ctx->s = 0;
+    while (ctx->q.even()) {
+        ctx->s += 1;
+        ctx->q /= 2;
+    }
+    ctx->q_m1_d2 = (ctx->q - 1) / 2;
+    // Least quadratic non-residue, the same on every run and every process
+    ctx->non_residue = 2;
+    while (1 == ctx->non_residue.pow_mod(ctx->p_m1_d2, p)) {
+        ++ctx->non_residue;
+    }
+    ctx->z = ctx->non_residue.pow_mod(ctx->q, p);
+    // Montgomery constants
+    ctx->limbs = (p.bits_size() + 63) / 64;
+    ctx->r = (BigInt(1) << static_cast<uint32_t>(64 * ctx->limbs)) % p;
+    ctx->r2 = ctx->r * ctx->r % p;
+    auto bytes = p.bytes(LE);
+    uint64_t p0 = 0;
+    for (size_t i = 0; i < bytes.size() && i < 8; ++i) {
+        p0 |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+    }
+    uint64_t inv = p0; // Newton's iteration, correct to 3 bits and doubling each step
+    for (size_t i = 0; i < 5; ++i) {
+        inv *= 2 - p0 * inv;
+    }
+    ctx->n_prime = 0 - inv;
+    return ctx;
+}
+
+std::shared_ptr<const FieldContext> Fp1::context_of(const BigInt& prime) {
+    static std::shared_mutex mutex;
+    static std::map<BigInt, std::shared_ptr<const FieldContext>> registry;
+    {
+        std::shared_lock lock(mutex);
+        auto it = registry.find(prime);
+        if (registry.end() != it) {
+            return it->second;
+        }
     }
+    auto ctx = make_context(prime); // Computed without the lock, the first insertion wins on a race
+    std::unique_lock lock(mutex);
+    return registry.try_emplace(prime, std::move(ctx)).first->second;
 }
 
+Fp1::Fp1(BigInt prime)
+    : ctx_(context_of(prime))
+    , p_(ctx_->p)
+{}
+
 BigInt Fp1::mod_reduce(const BigInt& a) const {
     BigInt r = a % p_;
     if (r < 0) {
@@ -41,26 +76,20 @@ BigInt Fp1::mod_reduce(const BigInt& a) const {
 }
 
 BigInt Fp1::add(const BigInt& a, const BigInt& b) const {
-    BigInt r = (a + b) % p_;
-    if (r < 0) {
-        r += p_;
-    }
+    BigInt r;
+    add_into(r, a, b);
     return r;
 }
 
 BigInt Fp1::sub(const BigInt& a, const BigInt& b) const {
-    return (a % p_ - b % p_ + p_) % p_;
-}
-
-mpz_class mul(const mpz_class& a, const mpz_class& b) {
-    return (a % a - b % a + a) % a;
+    BigInt r;
+    sub_into(r, a, b);
+    return r;
 }
 
 BigInt Fp1::mul(const BigInt& a, const BigInt& b) const {
-    BigInt r = (a * b) % p_;
-    if (r < 0) {
-        r += p_;
-    }
+    BigInt r;
+    mul_into(r, a, b);
     return r;
 }
 
@@ -98,36 +127,47 @@ BigInt Fp1::square(const BigInt& a) const {
 
 // Tonelli–Shanks
 std::optional<BigInt> Fp1::sqrt(BigInt a) const {
+    if (prime::bn254() == p_) {
+        auto r = Fp254(a).sqrt();
+        if (std::nullopt == r) {
+            return std::nullopt;
+        }
+        return r->big_int();
+    }
     a = mod_reduce(a);
     if (0 == a) {
         return 0;
     }
-    if (!has_sqrt(a)) {
-        return std::nullopt;
-    }
-    auto opt_w = pow(a, q_m1_d2_);
+    auto opt_w = pow(a, ctx_->q_m1_d2);
     if (std::nullopt == opt_w) {
         return std::nullopt;
     }
     auto w = *opt_w;
-    BigInt v = s_;
-    BigInt z = z_;
-    BigInt x = mul(a, w);
-    BigInt b = mul(x, w);
+    auto v = ctx_->s;
+    BigInt z = ctx_->z;
+    BigInt x;
+    BigInt b;
+    BigInt b2k;
+    mul_into(x, a, w);
+    mul_into(b, x, w);
     while (1 != b) {
-        BigInt b2k = square(b);
-        BigInt k = 1;
+        // Least k with b ^ (2 ^ k) = 1, k = v in the first round means a ^ ((p - 1) / 2) != 1
+        mul_into(b2k, b, b);
+        uint32_t k = 1;
         while (1 != b2k) {
-            b2k = square(b2k);
+            mul_into(b2k, b2k, b2k);
             ++k;
         }
+        if (k >= v) {
+            return std::nullopt;
+        }
         w = z;
-        for (BigInt i = 0; i < v - k - 1; ++i) {
-            w = square(w);
+        for (uint32_t i = 0; i + k + 1 < v; ++i) {
+            mul_into(w, w, w);
         }
-        z = square(w);
-        b = mul(b, z);
-        x = mul(x, w);
+        mul_into(z, w, w);
+        mul_into(b, b, z);
+        mul_into(x, x, w);
         v = k;
     }
     return x;
@@ -137,18 +177,70 @@ std::optional<BigInt> Fp1::mod_inv(const BigInt& a) const {
     return mod_reduce(a).mod_inv(p_);
 }
 
+// Montgomery's trick, one inversion and 3 * (n - 1) multiplications
+void Fp1::batch_inv(std::span<BigInt> a) const {
+    std::vector<BigInt> prefix(a.size()); // prefix[i] = a[0] * ... * a[i - 1], zeros skipped
+    BigInt acc = 1;
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = mod_reduce(a[i]);
+        prefix[i] = acc;
+        if (0 != a[i]) {
+            mul_into(acc, acc, a[i]);
+        }
+    }
+    auto acc_inv = acc.mod_inv(p_);
+    if (std::nullopt == acc_inv) {
+        // Composite modulus and some element is not coprime to it, invert one by one
+        for (auto& e : a) {
+            e = mod_inv(e).value_or(0);
+        }
+        return;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (0 == a[i]) {
+            continue;
+        }
+        mul_into(prefix[i], prefix[i], *acc_inv); // prefix[i] becomes a[i]⁻¹
+        mul_into(*acc_inv, *acc_inv, a[i]);
+        std::swap(a[i], prefix[i]);
+    }
+}
+
 BigInt Fp1::neg(const BigInt& a) const {
     BigInt r = mod_reduce(a);
     return r == 0 ? r : (p_ - r);
 }
 
 bool Fp1::has_sqrt(const BigInt& a) const {
-    BigInt exp = (p_ - 1) / 2;
-    const auto r = pow(a, exp);
+    const auto r = pow(a, ctx_->p_m1_d2);
     if (std::nullopt == r) {
         return false;
     }
     return *r == 1;
 }
 
+void Fp1::add_into(BigInt& out, const BigInt& a, const BigInt& b) const {
+    BigInt::add(out, a, b);
+    BigInt::mod(out, out, p_);
+    if (out < 0) {
+        BigInt::add(out, out, p_);
+    }
+}
+
+void Fp1::sub_into(BigInt& out, const BigInt& a, const BigInt& b) const {
+    BigInt::sub(out, a, b);
+    BigInt::mod(out, out, p_);
+    if (out < 0) {
+        BigInt::add(out, out, p_);
+    }
+}
+
+void Fp1::mul_into(BigInt& out, const BigInt& a, const BigInt& b) const {
+    BigInt::mul(out, a, b);
+    BigInt::mod(out, out, p_);
+    if (out < 0) {
+        BigInt::add(out, out, p_);
+    }
+}
+
 } // namespace iden3math
@@ -0,0 +1,198 @@
+#include <iden3math/fp254.h>
+#include <iden3math/prime.h>
+#include <gmp.h>
+#include <array>
+#include <vector>
+
+namespace iden3math {
+
+using Limbs = Fp254::Limbs;
+
+// 2⁷⁶⁸ mod p, used to convert a plain inverse back into Montgomery form
+static constexpr Limbs R3 = {0x5e94d8e1b4bf0040, 0x2a489cbe1cfbb6b8, 0x893cc664a19fcfed, 0x0cf8594b7fcc657c};
+
+// (p - 1) / 2, Euler's criterion exponent
+static constexpr Limbs P_M1_D2 = {0xa1f0fac9f8000000, 0x9419f4243cdcb848, 0xdc2822db40c0ac2e, 0x183227397098d014};
+
+// Tonelli–Shanks square root, p - 1 = Q * (2 ^ S)
+static constexpr uint32_t S = 28;
+
+// (Q - 1) / 2
+static constexpr Limbs Q_M1_D2 = {0xcdcb848a1f0fac9f, 0x0c0ac2e9419f4243, 0x098d014dc2822db4, 0x0000000183227397};
+
+// 5 ^ Q, 5 is a quadratic non-residue, Montgomery form
+static constexpr Limbs Z = {0x636e735580d13d9c, 0xa22bf3742445ffd6, 0x56452ac01eb203d8, 0x1860ef942963f9e7};
+
+inline Limbs bigint_to_limbs(const BigInt& a) {
+    const auto& p = prime::bn254();
+    BigInt r = a % p;
+    if (r < 0) {
+        r += p;
+    }
+    auto bytes = r.bytes(LE);
+    Limbs limbs = {0, 0, 0, 0};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        limbs[i / 8] |= static_cast<uint64_t>(bytes[i]) << (i % 8 * 8);
+    }
+    return limbs;
+}
+
+Fp254::Fp254(const BigInt& a) : Fp254(from_limbs(bigint_to_limbs(a))) {}
+
+BigInt Fp254::big_int() const {
+    auto l = limbs();
+    ByteVec1D bytes(32);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<Byte>(l[i / 8] >> (i % 8 * 8));
+    }
+    return {bytes, LE};
+}
+
+// Sliding window of up to 4 bits over the odd powers a, a³, ..., a¹⁵
+Fp254 Fp254::pow(const Limbs& exp) const {
+    auto bit = [&exp](int32_t i) { return static_cast<uint32_t>(exp[i / 64] >> (i % 64)) & 1; };
+    std::array<Fp254, 8> odd;
+    odd[0] = *this;
+    const auto a2 = square();
+    for (size_t i = 1; i < odd.size(); ++i) {
+        odd[i] = odd[i - 1] * a2;
+    }
+    Fp254 r = one();
+    bool started = false;
+    int32_t i = 255;
+    while (i >= 0) {
+        if (!bit(i)) {
+            if (started) {
+                r = r.square();
+            }
+            --i;
+            continue;
+        }
+        // Longest window [l, i] whose lowest bit is set
+        int32_t l = i > 3 ? i - 3 : 0;
+        while (!bit(l)) {
+            ++l;
+        }
+        uint32_t value = 0;
+        for (int32_t j = i; j >= l; --j) {
+            value = value << 1 | bit(j);
+            if (started) {
+                r = r.square();
+            }
+        }
+        r = started ? r * odd[value / 2] : odd[value / 2];
+        started = true;
+        i = l - 1;
+    }
+    return r;
+}
+
+Fp254 Fp254::pow(const BigInt& exp) const {
+    Fp254 base = *this;
+    Fp254 r = one();
+    auto bytes = exp.bytes(LE);
+    for (const auto& byte : bytes) {
+        for (size_t bit = 0; bit < 8; ++bit) {
+            if ((byte >> bit) & 1) {
+                r *= base;
+            }
+            base = base.square();
+        }
+    }
+    return r;
+}
+
+// Scratch integer reused by every inversion in the same thread, avoids allocation
+class InvScratch {
+public:
+    InvScratch() { mpz_init2(value_, 320); }
+    ~InvScratch() { mpz_clear(value_); }
+    mpz_ptr get() { return value_; }
+private:
+    mpz_t value_;
+};
+
+Fp254 Fp254::inv() const {
+    if (is_zero()) {
+        return {};
+    }
+    // m_ = a * R, gmp gives (a * R)⁻¹ = a⁻¹ * R⁻¹, then multiply R³ in Montgomery to get a⁻¹ * R
+    static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), "64-bit GMP limbs required");
+    thread_local InvScratch scratch;
+    mpz_t a;
+    mpz_t p;
+    mpz_roinit_n(a, reinterpret_cast<const mp_limb_t*>(m_.data()), 4);
+    mpz_roinit_n(p, reinterpret_cast<const mp_limb_t*>(modulus().data()), 4);
+    mpz_invert(scratch.get(), a, p);
+    Limbs plain = {0, 0, 0, 0};
+    const auto n = mpz_size(scratch.get());
+    for (size_t i = 0; i < n; ++i) {
+        plain[i] = mpz_getlimbn(scratch.get(), i);
+    }
+    return from_mont(plain) * from_mont(R3);
+}
+
+// Montgomery's trick, one inversion and 3 * (n - 1) multiplications
+void Fp254::batch_inv(std::span<Fp254> a) {
+    std::vector<Fp254> prefix(a.size()); // prefix[i] = a[0] * ... * a[i - 1], zeros skipped
+    auto acc = one();
+    for (size_t i = 0; i < a.size(); ++i) {
+        prefix[i] = acc;
+        if (!a[i].is_zero()) {
+            acc *= a[i];
+        }
+    }
+    auto acc_inv = acc.inv();
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i].is_zero()) {
+            continue;
+        }
+        auto inv = acc_inv * prefix[i];
+        acc_inv *= a[i];
+        a[i] = inv;
+    }
+}
+
+// ROOTS[i] = Z ^ (2 ^ i), Z is a primitive 2 ^ S-th root of unity
+static constexpr std::array<Fp254, S> ROOTS = [] {
+    std::array<Fp254, S> roots;
+    roots[0] = Fp254::from_mont(Z);
+    for (size_t i = 1; i < roots.size(); ++i) {
+        roots[i] = roots[i - 1].square();
+    }
+    return roots;
+}();
+
+// Tonelli–Shanks, the Legendre symbol a ^ ((p - 1) / 2) = b ^ (2 ^ (S - 1)) falls out of the first round
+std::optional<Fp254> Fp254::sqrt() const {
+    if (is_zero()) {
+        return zero();
+    }
+    auto w = pow(Q_M1_D2); // a ^ ((Q - 1) / 2)
+    auto x = *this * w;    // a ^ ((Q + 1) / 2)
+    auto b = x * w;        // a ^ Q
+    uint32_t v = S;
+    while (!b.is_one()) {
+        // Least k with b ^ (2 ^ k) = 1, k = v in the first round means a is a non-residue
+        auto b2k = b.square();
+        uint32_t k = 1;
+        while (!b2k.is_one()) {
+            b2k = b2k.square();
+            ++k;
+        }
+        if (k >= v) {
+            return std::nullopt;
+        }
+        // z stays Z ^ (2 ^ (S - v)), so w = z ^ (2 ^ (v - k - 1)) and z = w² are table lookups
+        x *= ROOTS[S - k - 1];
+        b *= ROOTS[S - k];
+        v = k;
+    }
+    return x;
+}
+
+bool Fp254::has_sqrt() const {
+    return pow(P_M1_D2).is_one();
+}
+
+} // namespace iden3math
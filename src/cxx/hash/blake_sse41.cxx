@@ -0,0 +1,72 @@
+#include "blake_rounds.h"
+
+#if defined(IDEN3MATH_X86_SIMD)
+#include <immintrin.h>
+
+namespace iden3math::hash::blake {
+
+namespace {
+
+inline __m128i rotr12(__m128i x) { return _mm_or_si128(_mm_srli_epi32(x, 12), _mm_slli_epi32(x, 20)); }
+inline __m128i rotr7(__m128i x) { return _mm_or_si128(_mm_srli_epi32(x, 7), _mm_slli_epi32(x, 25)); }
+
+// G on the four lanes, x and y are the message words xor constants of the two half steps
+inline void g(__m128i& a, __m128i& b, __m128i& c, __m128i& d, __m128i x, __m128i y) {
+    const __m128i rot16 = _mm_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m128i rot8 = _mm_set_epi8(12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1);
+    a = _mm_add_epi32(_mm_add_epi32(a, x), b);
+    d = _mm_shuffle_epi8(_mm_xor_si128(d, a), rot16);
+    c = _mm_add_epi32(c, d);
+    b = rotr12(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(_mm_add_epi32(a, y), b);
+    d = _mm_shuffle_epi8(_mm_xor_si128(d, a), rot8);
+    c = _mm_add_epi32(c, d);
+    b = rotr7(_mm_xor_si128(b, c));
+}
+
+// Message words xor constants for the G functions at SIGMA[r][e], SIGMA[r][e + 2], ... of one step
+inline void words(const uint32_t* m, const uint8_t* s, __m128i& x, __m128i& y) {
+    x = _mm_set_epi32(static_cast<int>(m[s[6]] ^ U256[s[7]]), static_cast<int>(m[s[4]] ^ U256[s[5]]),
+                      static_cast<int>(m[s[2]] ^ U256[s[3]]), static_cast<int>(m[s[0]] ^ U256[s[1]]));
+    y = _mm_set_epi32(static_cast<int>(m[s[7]] ^ U256[s[6]]), static_cast<int>(m[s[5]] ^ U256[s[4]]),
+                      static_cast<int>(m[s[3]] ^ U256[s[2]]), static_cast<int>(m[s[1]] ^ U256[s[0]]));
+}
+
+} // namespace
+
+void compress_sse41(uint32_t* h, uint64_t counter, const uint8_t* block) {
+    const __m128i bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    alignas(16) uint32_t m[16];
+    for (int i = 0; i < 4; ++i) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        _mm_store_si128(reinterpret_cast<__m128i*>(m + i * 4), _mm_shuffle_epi8(raw, bswap));
+    }
+    const auto t0 = static_cast<int>(static_cast<uint32_t>(counter));
+    const auto t1 = static_cast<int>(static_cast<uint32_t>(counter >> 32));
+    const __m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h));
+    const __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + 4));
+    __m128i row1 = h0;
+    __m128i row2 = h1;
+    __m128i row3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(U256));
+    __m128i row4 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(U256 + 4)), _mm_set_epi32(t1, t1, t0, t0));
+    __m128i x, y;
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        // Column step
+        words(m, SIGMA[r], x, y);
+        g(row1, row2, row3, row4, x, y);
+        // Diagonal step, rotate the rows so the diagonals line up as columns
+        row2 = _mm_shuffle_epi32(row2, _MM_SHUFFLE(0, 3, 2, 1));
+        row3 = _mm_shuffle_epi32(row3, _MM_SHUFFLE(1, 0, 3, 2));
+        row4 = _mm_shuffle_epi32(row4, _MM_SHUFFLE(2, 1, 0, 3));
+        words(m, SIGMA[r] + 8, x, y);
+        g(row1, row2, row3, row4, x, y);
+        row2 = _mm_shuffle_epi32(row2, _MM_SHUFFLE(2, 1, 0, 3));
+        row3 = _mm_shuffle_epi32(row3, _MM_SHUFFLE(1, 0, 3, 2));
+        row4 = _mm_shuffle_epi32(row4, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(h), _mm_xor_si128(h0, _mm_xor_si128(row1, row3)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(h + 4), _mm_xor_si128(h1, _mm_xor_si128(row2, row4)));
+}
+
+} // namespace iden3math::hash::blake
+#endif
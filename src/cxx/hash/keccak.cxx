@@ -1,6 +1,10 @@
 #include <iden3math/hash/keccak.h>
+#include "keccak_lanes.h"
 #include <iden3math/serialize.h>
+#include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <stdexcept>
 
 namespace iden3math::hash {
 
@@ -28,17 +32,6 @@ namespace iden3math::hash {
 // block[15] = a[0, 3], block[16] = a[1, 3], block[17] = a[2, 3], block[18] = a[3, 3], block[19] = a[4, 3]
 // block[20] = a[0, 4], block[21] = a[1, 4], block[22] = a[2, 4], block[23] = a[3, 4], block[24] = a[4, 4]
 
-static constexpr uint64_t ROUND_CONSTANTS_F1600[24] = {
-    0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
-    0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
-    0x8000000080008081, 0x8000000000008009, 0x000000000000008a,
-    0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
-    0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
-    0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
-    0x000000000000800a, 0x800000008000000a, 0x8000000080008081,
-    0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
-};
-
 uint64_t rotate_left(uint64_t r, int n) {
     return (r << n) | (r >> (64 - n));
 }
@@ -47,7 +40,7 @@ void f1600(uint64_t* block) {
     uint64_t C[5];
     uint64_t tmp1, tmp2;
 
-    for (const uint64_t constant : ROUND_CONSTANTS_F1600) {
+    for (const uint64_t constant : lanes::ROUND_CONSTANTS_F1600) {
         // THETA
         C[0] = block[0]  ^ block[1]  ^ block[2]  ^ block[3]  ^ block[4];
         C[1] = block[5]  ^ block[6]  ^ block[7]  ^ block[8]  ^ block[9];
@@ -128,70 +121,78 @@ void f1600(uint64_t* block) {
     }
 }
 
-void keccak256(const ByteVec1D& bytes, ByteVec1D& digest) {
-    uint32_t block_pos[25]  = {0, 5, 10, 15, 20, 1, 6, 11, 16, 21, 2, 7, 12, 17, 22, 3, 8, 13, 18, 23, 4, 9, 14, 19, 24};
-    uint32_t num_of_seg_136 = bytes.size() / 136;       // Number of segments that has exactly 136 bytes
-    uint32_t rest_data_size = bytes.size() % 136;       // Number of remaining bytes that is less than 136
-    uint32_t blks_per_seg   = 136 / sizeof(uint64_t);   // Number of 64-bit blocks in a segment
-    uint32_t feed           = 0;
-    uint64_t state[25]      = {};
-
-    // Absorb, XOR the whole 136-byte segments, if it has
-    for (uint32_t i = 0; i < num_of_seg_136; ++i) {
-        for (size_t blk = 0; blk < blks_per_seg; ++blk) {
-            state[block_pos[blk]] ^= *reinterpret_cast<const uint64_t*>(bytes.data() + feed);
-            feed += sizeof(uint64_t);
-        }
-        f1600(state);
+// XOR one RATE-byte segment into the state and permute, the i-th 64-bit word of the segment goes to a[i % 5, i / 5]
+static void absorb(uint64_t* state, const uint8_t* segment) {
+    static constexpr uint32_t BLOCK_POS[Keccak256::RATE / sizeof(uint64_t)] = {0, 5, 10, 15, 20, 1, 6, 11, 16, 21, 2, 7, 12, 17, 22, 3, 8};
+    for (size_t blk = 0; blk < std::size(BLOCK_POS); ++blk) {
+        uint64_t word;
+        std::memcpy(&word, segment + blk * sizeof(uint64_t), sizeof(uint64_t));
+        state[BLOCK_POS[blk]] ^= word;
     }
+    f1600(state);
+}
 
-    // Absorb, XOR the last segment
-    size_t blk = 0;
-    uint64_t pad_start_block = 0;
-    // XOR 8-byte blocks of rest data
-    uint32_t rest_blocks = rest_data_size / sizeof(uint64_t);
-    for (; blk < rest_blocks; ++blk) {
-        state[block_pos[blk]] ^= *reinterpret_cast<const uint64_t*>(bytes.data() + feed);
-        feed += sizeof(uint64_t);
+void Keccak256::update(std::span<const uint8_t> bytes) {
+    // Complete the buffered segment first
+    if (0 != buffered_) {
+        const auto n = std::min(RATE - buffered_, bytes.size());
+        std::memcpy(buffer_ + buffered_, bytes.data(), n);
+        buffered_ += n;
+        bytes = bytes.subspan(n);
+        if (RATE != buffered_) {
+            return;
+        }
+        absorb(state_, buffer_);
+        buffered_ = 0;
     }
-    // Copy rest bytes
-    size_t rest_bytes = rest_data_size % sizeof(uint64_t);
-    std::memcpy(&pad_start_block, bytes.data() + feed, rest_bytes);
-    feed += rest_bytes;
-    // Pad10*1
-    pad_start_block |= static_cast<uint64_t>(0x01) << rest_bytes * 8;
-    if (blk == blks_per_seg - 1) {
-        state[block_pos[blk]] ^= pad_start_block | 0x8000000000000000;
-    } else {
-        state[block_pos[blk]] ^= pad_start_block;
+    // Whole segments straight from the input
+    while (bytes.size() >= RATE) {
+        absorb(state_, bytes.data());
+        bytes = bytes.subspan(RATE);
     }
-    ++blk;
-    for (; blk < blks_per_seg; ++blk) {
-        if (blk == blks_per_seg - 1) {
-            state[block_pos[blk]] ^= 0x8000000000000000;
-        } else {
-            state[block_pos[blk]] ^= 0x00;
-        }
+    if (!bytes.empty()) {
+        std::memcpy(buffer_, bytes.data(), bytes.size());
     }
-    // Permutation
-    f1600(state);
+    buffered_ = bytes.size();
+}
 
+void Keccak256::finalize(std::span<uint8_t, 32> digest) {
+    // Pad10*1
+    std::memset(buffer_ + buffered_, 0, RATE - buffered_);
+    buffer_[buffered_] ^= 0x01;
+    buffer_[RATE - 1] ^= 0x80;
+    absorb(state_, buffer_);
     // Squeeze out the digest
-    digest.clear();
-    digest.resize(32);
-    digest.reserve(32);
-    std::memcpy(&digest[0 * sizeof (uint64_t)], &state[0], sizeof(uint64_t));
-    std::memcpy(&digest[1 * sizeof (uint64_t)], &state[5], sizeof(uint64_t));
-    std::memcpy(&digest[2 * sizeof (uint64_t)], &state[10], sizeof(uint64_t));
-    std::memcpy(&digest[3 * sizeof (uint64_t)], &state[15], sizeof(uint64_t));
+    std::memcpy(&digest[0 * sizeof (uint64_t)], &state_[0], sizeof(uint64_t));
+    std::memcpy(&digest[1 * sizeof (uint64_t)], &state_[5], sizeof(uint64_t));
+    std::memcpy(&digest[2 * sizeof (uint64_t)], &state_[10], sizeof(uint64_t));
+    std::memcpy(&digest[3 * sizeof (uint64_t)], &state_[15], sizeof(uint64_t));
+    reset();
+}
+
+std::array<uint8_t, 32> Keccak256::finalize() {
+    std::array<uint8_t, 32> digest;
+    finalize(digest);
+    return digest;
+}
+
+void Keccak256::reset() {
+    std::memset(state_, 0, sizeof(state_));
+    buffered_ = 0;
+}
+
+void keccak256(const ByteVec1D& bytes, ByteVec1D& digest) {
+    Keccak256 hasher;
+    hasher.update(bytes);
+    const auto result = hasher.finalize(); // Input fully absorbed, digest may alias it
+    digest.assign(result.begin(), result.end());
 }
 
 void keccak256(const std::string& text, ByteVec1D& digest) {
-    ByteVec1D bytes;
-    for (const char& c : text) {
-        bytes.push_back(static_cast<uint8_t>(c));
-    }
-    keccak256(bytes, digest);
+    Keccak256 hasher;
+    hasher.update({reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+    const auto result = hasher.finalize();
+    digest.assign(result.begin(), result.end());
 }
 
 void keccak256(const BigInt& number, ByteVec1D& digest) {
@@ -204,4 +205,48 @@ void keccak256(const BigInt& number, ByteVec1D& digest) {
     keccak256(bytes, digest);
 }
 
+uint32_t keccak256_many_lanes() {
+#if defined(IDEN3MATH_X86_SIMD)
+    static const uint32_t LANES = __builtin_cpu_supports("avx512f") ? 8 : __builtin_cpu_supports("avx2") ? 4 : 1;
+    return LANES;
+#else
+    return 1;
+#endif
+}
+
+void keccak256_many(std::span<const std::span<const uint8_t>> inputs, std::span<std::array<uint8_t, 32>> digests, uint32_t max_lanes) {
+    if (inputs.size() != digests.size()) {
+        throw std::invalid_argument("Number of inputs and digests mismatch");
+    }
+    size_t i = 0;
+#if defined(IDEN3MATH_X86_SIMD)
+    const auto lanes = std::min(keccak256_many_lanes(), max_lanes);
+    const uint8_t* data[8];
+    size_t sizes[8];
+    const auto interleave = [&](size_t n, auto kernel) {
+        for (; i + n <= inputs.size(); i += n) {
+            for (size_t l = 0; l < n; ++l) {
+                data[l] = inputs[i + l].data();
+                sizes[l] = inputs[i + l].size();
+            }
+            kernel(data, sizes, digests[i].data());
+        }
+    };
+    if (lanes >= 8) {
+        interleave(8, lanes::keccak256_x8);
+    }
+    if (lanes >= 4) {
+        interleave(4, lanes::keccak256_x4);
+    }
+#else
+    (void)max_lanes;
+#endif
+    // Leftovers and CPUs without SIMD
+    Keccak256 hasher;
+    for (; i < inputs.size(); ++i) {
+        hasher.update(inputs[i]);
+        hasher.finalize(digests[i]);
+    }
+}
+
 } // namespace iden3math::hash
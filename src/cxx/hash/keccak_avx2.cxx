@@ -0,0 +1,32 @@
+#include "keccak_lanes.h"
+
+#if defined(IDEN3MATH_X86_SIMD)
+#include <immintrin.h>
+
+namespace iden3math::hash::lanes {
+
+namespace {
+
+struct Avx2 {
+    using V = __m256i;
+    static constexpr size_t LANES = 4;
+
+    static V zero() { return _mm256_setzero_si256(); }
+    static V set1(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+    static V load(const uint64_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint64_t* p, V x) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), x); }
+    static V xor2(V a, V b) { return _mm256_xor_si256(a, b); }
+    static V xor5(V a, V b, V c, V d, V e) { return xor2(xor2(xor2(a, b), xor2(c, d)), e); }
+    template <int N>
+    static V rotl(V x) { return 0 == N ? x : _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - N)); }
+    static V chi(V a, V b, V c) { return _mm256_xor_si256(a, _mm256_andnot_si256(b, c)); }
+};
+
+} // namespace
+
+void keccak256_x4(const uint8_t* const* data, const size_t* sizes, uint8_t* digests) {
+    keccak256<Avx2>(data, sizes, digests);
+}
+
+} // namespace iden3math::hash::lanes
+#endif
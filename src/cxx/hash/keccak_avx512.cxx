@@ -0,0 +1,32 @@
+#include "keccak_lanes.h"
+
+#if defined(IDEN3MATH_X86_SIMD)
+#include <immintrin.h>
+
+namespace iden3math::hash::lanes {
+
+namespace {
+
+struct Avx512 {
+    using V = __m512i;
+    static constexpr size_t LANES = 8;
+
+    static V zero() { return _mm512_setzero_si512(); }
+    static V set1(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+    static V load(const uint64_t* p) { return _mm512_load_si512(p); }
+    static void store(uint64_t* p, V x) { _mm512_store_si512(p, x); }
+    static V xor2(V a, V b) { return _mm512_xor_si512(a, b); }
+    static V xor5(V a, V b, V c, V d, V e) { return _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96); }
+    template <int N>
+    static V rotl(V x) { return 0 == N ? x : _mm512_maskz_rol_epi64(0xff, x, N); } // Not _mm512_rol_epi64, GCC 12 warns on its undefined source
+    static V chi(V a, V b, V c) { return _mm512_ternarylogic_epi64(a, b, c, 0xd2); } // a ^ (~b & c)
+};
+
+} // namespace
+
+void keccak256_x8(const uint8_t* const* data, const size_t* sizes, uint8_t* digests) {
+    keccak256<Avx512>(data, sizes, digests);
+}
+
+} // namespace iden3math::hash::lanes
+#endif
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// Multi-buffer Keccak-f[1600], N independent states interleaved in the lanes of a SIMD register
+// With the one-lane Scalar ops the same permutation runs in constant expressions
+//
+// Each kernel lives in its own translation unit built with its instruction set (see CMakeLists.txt),
+// only raw pointers cross the boundary so no inline function of the standard library is emitted
+// with wider instructions than the caller's CPU may have
+
+namespace iden3math::hash::lanes {
+
+static constexpr size_t RATE = 136;
+
+static constexpr uint64_t ROUND_CONSTANTS_F1600[24] = {
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
+    0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+    0x8000000080008081, 0x8000000000008009, 0x000000000000008a,
+    0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
+    0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+    0x000000000000800a, 0x800000008000000a, 0x8000000080008081,
+    0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+};
+
+// Rotation offsets of a[x + 5 * y]
+static constexpr int RHO[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14,
+};
+
+// RHO PI of lane i = x + 5 * y, unrolled so every rotation amount is a constant
+template <typename Ops, size_t... I>
+constexpr void rho_pi(typename Ops::V* b, const typename Ops::V* a, const typename Ops::V* d, std::index_sequence<I...>) {
+    ((b[I / 5 + 5 * ((2 * (I % 5) + 3 * (I / 5)) % 5)] = Ops::template rotl<RHO[I]>(Ops::xor2(a[I], d[I % 5]))), ...);
+}
+
+// Keccak-f[1600] on a[x + 5 * y], Ops supplies the vector type V and its bitwise operations
+template <typename Ops>
+constexpr void f1600(typename Ops::V* a) {
+    using V = typename Ops::V;
+    V c[5], d[5], b[25];
+    for (const uint64_t constant : ROUND_CONSTANTS_F1600) {
+        // THETA
+        for (int x = 0; x < 5; ++x) {
+            c[x] = Ops::xor5(a[x], a[x + 5], a[x + 10], a[x + 15], a[x + 20]);
+        }
+        for (int x = 0; x < 5; ++x) {
+            d[x] = Ops::xor2(c[(x + 4) % 5], Ops::template rotl<1>(c[(x + 1) % 5]));
+        }
+        rho_pi<Ops>(b, a, d, std::make_index_sequence<25>());
+        // CHI
+        for (int y = 0; y < 5; ++y) {
+            for (int x = 0; x < 5; ++x) {
+                a[x + 5 * y] = Ops::chi(b[x + 5 * y], b[(x + 1) % 5 + 5 * y], b[(x + 2) % 5 + 5 * y]);
+            }
+        }
+        // IOTA
+        a[0] = Ops::xor2(a[0], Ops::set1(constant));
+    }
+}
+
+// One lane in a plain 64-bit word, every operation is constexpr
+struct Scalar {
+    using V = uint64_t;
+    static constexpr size_t LANES = 1;
+
+    static constexpr V set1(uint64_t x) { return x; }
+    static constexpr V xor2(V a, V b) { return a ^ b; }
+    static constexpr V xor5(V a, V b, V c, V d, V e) { return a ^ b ^ c ^ d ^ e; }
+    template <int N>
+    static constexpr V rotl(V x) {
+        if constexpr (0 == N) {
+            return x;
+        } else {
+            return (x << N) | (x >> (64 - N));
+        }
+    }
+    static constexpr V chi(V a, V b, V c) { return a ^ (~b & c); }
+};
+
+// Keccak256 of a message shorter than RATE bytes, for tables built at compile time
+template <typename T>
+constexpr std::array<uint8_t, 32> keccak256_short(const T* data, size_t size) {
+    uint64_t a[25] = {};
+    for (size_t i = 0; i < size; ++i) {
+        a[i / 8] ^= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (i % 8 * 8);
+    }
+    a[size / 8] ^= uint64_t(0x01) << (size % 8 * 8);
+    a[RATE / 8 - 1] ^= uint64_t(0x80) << 56;
+    f1600<Scalar>(a);
+    std::array<uint8_t, 32> digest = {};
+    for (size_t i = 0; i < digest.size(); ++i) {
+        digest[i] = static_cast<uint8_t>(a[i / 8] >> (i % 8 * 8));
+    }
+    return digest;
+}
+
+// Keccak256 of Ops::LANES messages at once, messages may differ in length
+template <typename Ops>
+inline void keccak256(const uint8_t* const* data, const size_t* sizes, uint8_t* digests) {
+    using V = typename Ops::V;
+    constexpr size_t N = Ops::LANES;
+    constexpr size_t WORDS = RATE / sizeof(uint64_t);
+
+    V a[25];
+    for (auto& v : a) {
+        v = Ops::zero();
+    }
+    // Segments to absorb per message, the last one carries the padding
+    size_t blocks[N];
+    size_t max_blocks = 0;
+    for (size_t l = 0; l < N; ++l) {
+        blocks[l] = sizes[l] / RATE + 1;
+        max_blocks = blocks[l] > max_blocks ? blocks[l] : max_blocks;
+    }
+
+    alignas(64) uint64_t words[WORDS][N];
+    alignas(64) uint64_t out[N];
+    uint8_t tail[RATE];
+    for (size_t blk = 0; blk < max_blocks; ++blk) {
+        // Transpose the segments, words[w][l] is the w-th word of message l
+        for (size_t l = 0; l < N; ++l) {
+            const uint8_t* segment = tail;
+            if (blk + 1 < blocks[l]) {
+                segment = data[l] + blk * RATE;
+            } else if (blk + 1 == blocks[l]) {
+                // Pad10*1
+                const size_t rest = sizes[l] - blk * RATE;
+                if (0 != rest) {
+                    std::memcpy(tail, data[l] + blk * RATE, rest);
+                }
+                std::memset(tail + rest, 0, RATE - rest);
+                tail[rest] ^= 0x01;
+                tail[RATE - 1] ^= 0x80;
+            } else {
+                // Finished already, keep the lane busy with zeros
+                for (size_t w = 0; w < WORDS; ++w) {
+                    words[w][l] = 0;
+                }
+                continue;
+            }
+            for (size_t w = 0; w < WORDS; ++w) {
+                std::memcpy(&words[w][l], segment + w * sizeof(uint64_t), sizeof(uint64_t));
+            }
+        }
+        for (size_t w = 0; w < WORDS; ++w) {
+            a[w] = Ops::xor2(a[w], Ops::load(words[w]));
+        }
+        f1600<Ops>(a);
+        // Squeeze the messages whose last segment was just absorbed
+        for (size_t w = 0; w < 4; ++w) {
+            Ops::store(out, a[w]);
+            for (size_t l = 0; l < N; ++l) {
+                if (blk + 1 == blocks[l]) {
+                    std::memcpy(digests + l * 32 + w * sizeof(uint64_t), &out[l], sizeof(uint64_t));
+                }
+            }
+        }
+    }
+}
+
+#if defined(IDEN3MATH_X86_SIMD)
+// keccak256<Ops> over 4 messages with AVX2, digests is 4 x 32 bytes
+void keccak256_x4(const uint8_t* const* data, const size_t* sizes, uint8_t* digests);
+
+// keccak256<Ops> over 8 messages with AVX-512, digests is 8 x 32 bytes
+void keccak256_x8(const uint8_t* const* data, const size_t* sizes, uint8_t* digests);
+#endif
+
+} // namespace iden3math::hash::lanes
@@ -1,119 +1,195 @@
 #include <iden3math/bigint.h>
-#include <iden3math/hash/keccak.h>
+#include <iden3math/fp254.h>
 #include <iden3math/hash/mimc.h>
 #include <iden3math/prime.h>
-#include <iden3math/serialize.h>
-#include <mutex>
+#include "cxx/parallel.h"
+#include "keccak_lanes.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
 
 namespace iden3math::hash {
 
 static constexpr uint32_t ROUNDS = 220;
 
-static constexpr uint32_t EXPONENT = 5;
+static constexpr char CONSTANT_SEED[] = "mimcsponge";
 
-static const std::string CONSTANT_SEED = "mimcsponge";
-
-static std::vector<BigInt> CONSTANTS;
-
-std::once_flag CONSTANTS_INIT_ONCE_FLAG;
-
-void init() {
-    CONSTANTS.reserve(ROUNDS);
-    CONSTANTS.emplace_back("00", 16);
-    ByteVec1D digest;
-    keccak256(CONSTANT_SEED, digest);
+// Montgomery form, CONSTANTS[0] = CONSTANTS[ROUNDS - 1] = 0, CONSTANTS[i] = keccak256ⁱ⁺¹(CONSTANT_SEED) read big-endian
+// Evaluated by the compiler, nothing runs at startup
+static constexpr std::array<Fp254, ROUNDS> CONSTANTS = [] {
+    std::array<Fp254, ROUNDS> constants;
+    auto digest = lanes::keccak256_short(CONSTANT_SEED, sizeof(CONSTANT_SEED) - 1);
     for (size_t i = 1; i < ROUNDS - 1; ++i) {
-        if (digest.size() < 32) {
-            serialize::pad(digest, 0x00, 32 - digest.size(), true);
+        digest = lanes::keccak256_short(digest.data(), digest.size());
+        Fp254::Limbs limbs = {0, 0, 0, 0};
+        for (size_t j = 0; j < digest.size(); ++j) {
+            const size_t n = digest.size() - 1 - j;
+            limbs[n / 8] |= static_cast<uint64_t>(digest[j]) << (n % 8 * 8);
         }
-        keccak256(digest, digest);
-        CONSTANTS.emplace_back(BigInt(digest, BE) % prime::bn254());
+        constants[i] = Fp254::from_limbs(limbs);
     }
-    CONSTANTS.emplace_back("00", 16);
+    return constants;
+}();
+
+// Up to 32 bytes are packed straight into limbs, from_limbs() reduces anything below 2²⁵⁶
+static Fp254 to_field(std::span<const uint8_t> data, Endian endian) {
+    if (data.size() > 32) {
+        return Fp254(BigInt::from_bytes(data, endian));
+    }
+    Fp254::Limbs limbs = {0, 0, 0, 0};
+    for (size_t i = 0; i < data.size(); ++i) {
+        const size_t n = BE == endian ? data.size() - 1 - i : i; // Significance of data[i]
+        limbs[n / 8] |= static_cast<uint64_t>(data[i]) << (n % 8 * 8);
+    }
+    return Fp254::from_limbs(limbs);
 }
 
-typedef struct FeistelState {
-    BigInt xL_in;
-    BigInt xR_in;
-    BigInt xL_out;
-    BigInt xR_out;
-} FeistelState;
+static void to_bytes(const Fp254& a, Endian endian, std::span<uint8_t, 32> bytes) {
+    const auto limbs = a.limbs();
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[BE == endian ? bytes.size() - 1 - i : i] = static_cast<Byte>(limbs[i / 8] >> (i % 8 * 8));
+    }
+}
 
-void feistel(const BigInt& xL_in, const BigInt& xR_in, const BigInt& k, BigInt& xL_out, BigInt& xR_out) {
-    std::call_once(CONSTANTS_INIT_ONCE_FLAG, init);
-    BigInt t = 0;
-    BigInt c = 0;
-    std::vector<BigInt> xL;
-    std::vector<BigInt> xR;
-    xL.reserve(ROUNDS); xL.resize(ROUNDS);
-    xR.reserve(ROUNDS); xR.resize(ROUNDS);
+// Each round: t = k + xL + c, (xL, xR) = (xR + t⁵, xL), the last round only adds t⁵ to xR
+// The state stays in two locals and t⁵ is two squarings and one multiply
+static inline void feistel(Fp254& xL, Fp254& xR, const Fp254& k) {
+    for (uint32_t i = 0; i < ROUNDS - 1; ++i) {
+        const auto t = k + xL + CONSTANTS[i];
+        const auto f = t.square().square() * t;
+        const auto xL_next = xR + f;
+        xR = xL;
+        xL = xL_next;
+    }
+    const auto t = k + xL; // CONSTANTS[ROUNDS - 1] = 0
+    xR += t.square().square() * t;
+}
 
-    for (int i = 0; i < ROUNDS; ++i) {
-        if (0 == i) {
-            t = (k + xL_in) % prime::bn254();
-        } else {
-            t = (k + xL[i - 1] + CONSTANTS[i]) % prime::bn254();
-        }
-        BigInt f;
-        f = t.pow_mod(EXPONENT, prime::bn254());
-        if (i < ROUNDS - 1) {
-            xL[i] = ((0 == i ? xR_in : xR[i - 1]) + f) % prime::bn254();
-            xR[i] = i==0 ? xL_in : xL[i - 1];
-        } else {
-            xR_out = (xR[i - 1] + f) % prime::bn254();
-            xL_out = xL[i - 1];
+// Sponges interleaved by the batch functions, more lanes lose to register pressure
+static constexpr size_t LANES = 4;
+
+// feistel() on N sponges, round i of all of them before round i + 1 of any, so the N multiply chains overlap
+template <size_t N>
+static inline void feistel_lanes(Fp254* xL, Fp254* xR, const Fp254& k) {
+    for (uint32_t i = 0; i < ROUNDS - 1; ++i) {
+        for (size_t l = 0; l < N; ++l) {
+            const auto t = k + xL[l] + CONSTANTS[i];
+            const auto f = t.square().square() * t;
+            const auto xL_next = xR[l] + f;
+            xR[l] = xL[l];
+            xL[l] = xL_next;
         }
     }
+    for (size_t l = 0; l < N; ++l) {
+        const auto t = k + xL[l];
+        xR[l] += t.square().square() * t;
+    }
 }
 
 void mimc_sponge(const ByteVec2D& preimages, size_t outputs, const ByteVec1D& key, ByteVec2D& digests, Endian preimage_endian, Endian key_endian, Endian digest_endian) {
-    std::vector<BigInt> in;
-    std::vector<BigInt> out;
-    for (const auto& data: preimages) {
-        in.emplace_back(BigInt(data, preimage_endian) % prime::bn254());
+    const auto k = to_field(key, key_endian);
+    Fp254 xL;
+    Fp254 xR;
+    for (const auto& data : preimages) {
+        xL += to_field(data, preimage_endian);
+        feistel(xL, xR, k);
     }
-    for (int i = 0; i < outputs; ++i) {
-        out.emplace_back(0);
+    // Preimages are fully absorbed, digests may alias them from here on
+    digests.resize(outputs);
+    for (size_t i = 0; i < outputs; ++i) {
+        if (0 != i) {
+            feistel(xL, xR, k);
+        }
+        digests[i].resize(32);
+        to_bytes(xL, digest_endian, std::span<uint8_t, 32>(digests[i].data(), 32));
     }
-    auto k = BigInt(key, key_endian);
-    k = k % prime::bn254();
-    const auto inputs = in.size();
-
-    std::vector<FeistelState> states;
-    states.reserve(inputs + outputs - 1);
-    states.resize(inputs + outputs - 1);
+}
 
-    for (int i = 0; i < inputs; ++i) {
-        if (0 == i) {
-            states[i].xL_in = in[i];
-            states[i].xR_in = 0;
-        } else {
-            states[i].xL_in = (states[i - 1].xL_out + in[i]) % prime::bn254();
-            states[i].xR_in = states[i - 1].xR_out;
+// Sponges [first, last) of mimc_sponge_batch(), LANES at a time
+static void sponge_range(std::span<const std::array<uint8_t, 32>> preimages, size_t count, size_t outputs, const Fp254& k,
+                         std::span<std::array<uint8_t, 32>> digests, Endian preimage_endian, Endian digest_endian, size_t first, size_t last) {
+    Fp254 xL[LANES];
+    Fp254 xR[LANES];
+    for (size_t s = first; s < last; s += LANES) {
+        const auto n = std::min(LANES, last - s);
+        for (size_t l = 0; l < n; ++l) {
+            xL[l] = Fp254();
+            xR[l] = Fp254();
+        }
+        for (size_t j = 0; j < outputs + count - 1; ++j) {
+            // Absorb preimage j, then squeeze with one permutation per extra output
+            if (j < count) {
+                for (size_t l = 0; l < n; ++l) {
+                    xL[l] += to_field(preimages[(s + l) * count + j], preimage_endian);
+                }
+            }
+            if (LANES == n) {
+                feistel_lanes<LANES>(xL, xR, k);
+            } else {
+                for (size_t l = 0; l < n; ++l) {
+                    feistel(xL[l], xR[l], k);
+                }
+            }
+            if (j + 1 >= count) {
+                for (size_t l = 0; l < n; ++l) {
+                    to_bytes(xL[l], digest_endian, digests[(s + l) * outputs + j + 1 - count]);
+                }
+            }
         }
-        feistel(states[i].xL_in, states[i].xR_in, k, states[i].xL_out, states[i].xR_out);
     }
+}
 
-    out[0] = states[inputs - 1].xL_out;
-    for (int i = 0; i < outputs - 1; ++i) {
-        states[inputs + i].xL_in = states[inputs + i - 1].xL_out;
-        states[inputs + i].xR_in = states[inputs + i - 1].xR_out;
-        feistel(states[inputs + i].xL_in, states[inputs + i].xR_in, k, states[inputs + i].xL_out, states[inputs + i].xR_out);
-        out[i + 1] = states[inputs + i].xL_out;
+void mimc_sponge_batch(std::span<const std::array<uint8_t, 32>> preimages, size_t count, size_t outputs, const ByteVec1D& key,
+                       std::span<std::array<uint8_t, 32>> digests, Endian preimage_endian, Endian key_endian, Endian digest_endian, uint32_t threads) {
+    if (0 == count || 0 != preimages.size() % count) {
+        throw std::invalid_argument("Number of preimages is not a multiple of the preimages per sponge");
+    }
+    const auto sponges = preimages.size() / count;
+    if (digests.size() != sponges * outputs) {
+        throw std::invalid_argument("Number of digests mismatch");
+    }
+    if (0 == outputs) {
+        return;
     }
+    const auto k = to_field(key, key_endian);
+    parallel_for(sponges, threads, [&](size_t first, size_t last) {
+        sponge_range(preimages, count, outputs, k, digests, preimage_endian, digest_endian, first, last);
+    });
+}
+
+Fp254 mimc_hash_pair(const Fp254& left, const Fp254& right) {
+    Fp254 xL = left;
+    Fp254 xR;
+    feistel(xL, xR, Fp254());
+    xL += right;
+    feistel(xL, xR, Fp254());
+    return xL;
+}
 
-    digests.clear();
-    for (const auto &o : out) {
-        auto hex = o.str(16);
-        if (hex.size() > 64) {
-            throw std::runtime_error("Hex string longer than 64");
+void mimc_hash_pairs(std::span<const Fp254> pairs, std::span<Fp254> out) {
+    if (pairs.size() != out.size() * 2) {
+        throw std::invalid_argument("Number of pairs and outputs mismatch");
+    }
+    Fp254 xL[LANES];
+    Fp254 xR[LANES];
+    size_t i = 0;
+    for (; i + LANES <= out.size(); i += LANES) {
+        for (size_t l = 0; l < LANES; ++l) {
+            xL[l] = pairs[(i + l) * 2];
+            xR[l] = Fp254();
+        }
+        feistel_lanes<LANES>(xL, xR, Fp254());
+        for (size_t l = 0; l < LANES; ++l) {
+            xL[l] += pairs[(i + l) * 2 + 1];
         }
-        auto bytes = *serialize::hexstr_to_bytes(hex);
-        if (digest_endian != BE) {
-            bytes = serialize::swap_endian(bytes);
+        feistel_lanes<LANES>(xL, xR, Fp254());
+        for (size_t l = 0; l < LANES; ++l) {
+            out[i + l] = xL[l];
         }
-        serialize::pad(bytes, 0x00, 32 - bytes.size(), digest_endian == BE);
-        digests.emplace_back(bytes);
+    }
+    for (; i < out.size(); ++i) {
+        out[i] = mimc_hash_pair(pairs[i * 2], pairs[i * 2 + 1]);
     }
 }
 
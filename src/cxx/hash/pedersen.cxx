@@ -96,8 +96,7 @@ void pedersen(const ByteVec1D& preimage, ByteVec1D& digest) {
         }
         acc_p = ec::babyjub::add(acc_p, ec::babyjub::mul_scalar(get_base_point(seg), escalar));
     }
-    digest = ec::babyjub::compress(acc_p, LE);
-    serialize::pad(digest, 0x00, 32 - digest.size(), false);
+    digest = ec::babyjub::compress(acc_p, LE); // Always 32 bytes
 }
 
 } // namespace iden3math::hash
@@ -0,0 +1,107 @@
+#include <iden3math/hash/poseidon.h>
+#include "cxx/parallel.h"
+#include "poseidon_constants.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace iden3math::hash {
+
+static inline Fp254 pow5(const Fp254& x) {
+    const auto x2 = x.square();
+    return x2.square() * x;
+}
+
+template <size_t T>
+static inline void mix(std::array<Fp254, T>& state, const std::array<std::array<Fp254, T>, T>& m) {
+    std::array<Fp254, T> out;
+    for (size_t i = 0; i < T; ++i) {
+        auto acc = m[i][0] * state[0];
+        for (size_t j = 1; j < T; ++j) {
+            acc += m[i][j] * state[j];
+        }
+        out[i] = acc;
+    }
+    state = out;
+}
+
+template <size_t T>
+static inline void full_round(std::array<Fp254, T>& state, const std::array<Fp254, T>& constants, const std::array<std::array<Fp254, T>, T>& m) {
+    for (size_t i = 0; i < T; ++i) {
+        state[i] = pow5(state[i] + constants[i]);
+    }
+    mix(state, m);
+}
+
+/**
+ * The permutation with the partial rounds rewritten as in the Poseidon paper's appendix, same output as circomlib's:
+ * - Constants of state[1..] in a partial round skip its S-box, tools/poseidon_constants.py carries them into the
+ *   next round so a partial round adds one constant
+ * - Each partial round's MDS is split into a sparse matrix and a block that leaves state[0] alone, the blocks move
+ *   ahead of the partial rounds into pre, so a partial round costs 2T - 1 multiplications instead of T²
+ */
+template <size_t T, size_t PARTIAL>
+static Fp254 permute(const poseidon_params::Params<T, PARTIAL>& params, const Fp254* inputs) {
+    constexpr size_t HALF = poseidon_params::FULL_ROUNDS / 2;
+    std::array<Fp254, T> state;
+    state[0] = Fp254::zero();
+    std::copy(inputs, inputs + T - 1, state.begin() + 1);
+    for (size_t r = 0; r < HALF - 1; ++r) {
+        full_round(state, params.full[r], params.mds);
+    }
+    full_round(state, params.full[HALF - 1], params.pre);
+    for (size_t r = 0; r < PARTIAL; ++r) {
+        const auto& sparse = params.sparse[r];
+        const auto x = pow5(state[0] + params.partial[r]);
+        auto first = sparse[0] * x;
+        for (size_t i = 1; i < T; ++i) {
+            first += sparse[i] * state[i];
+            state[i] += sparse[T + i - 1] * x;
+        }
+        state[0] = first;
+    }
+    for (size_t r = HALF; r < poseidon_params::FULL_ROUNDS; ++r) {
+        full_round(state, params.full[r], params.mds);
+    }
+    return state[0];
+}
+
+template <const auto& PARAMS>
+static Fp254 hash(const Fp254* inputs) {
+    return permute(PARAMS, inputs);
+}
+
+typedef Fp254 (*Hash)(const Fp254*);
+
+// HASHES[n - 1] hashes n inputs
+static constexpr Hash HASHES[POSEIDON_MAX_INPUTS] = {
+    hash<poseidon_params::WIDTH_2>, hash<poseidon_params::WIDTH_3>, hash<poseidon_params::WIDTH_4>, hash<poseidon_params::WIDTH_5>,
+    hash<poseidon_params::WIDTH_6>, hash<poseidon_params::WIDTH_7>, hash<poseidon_params::WIDTH_8>, hash<poseidon_params::WIDTH_9>,
+    hash<poseidon_params::WIDTH_10>, hash<poseidon_params::WIDTH_11>, hash<poseidon_params::WIDTH_12>, hash<poseidon_params::WIDTH_13>,
+    hash<poseidon_params::WIDTH_14>, hash<poseidon_params::WIDTH_15>, hash<poseidon_params::WIDTH_16>, hash<poseidon_params::WIDTH_17>,
+};
+
+static Hash select(size_t count) {
+    if (0 == count || count > POSEIDON_MAX_INPUTS) {
+        throw std::invalid_argument("Poseidon takes 1 to 16 inputs");
+    }
+    return HASHES[count - 1];
+}
+
+Fp254 poseidon(std::span<const Fp254> inputs) {
+    return select(inputs.size())(inputs.data());
+}
+
+void poseidon_batch(std::span<const Fp254> inputs, size_t count, std::span<Fp254> digests, uint32_t threads) {
+    const auto hash = select(count);
+    if (inputs.size() != count * digests.size()) {
+        throw std::invalid_argument("Number of inputs and digests mismatch");
+    }
+    parallel_for(digests.size(), threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            digests[i] = hash(inputs.data() + i * count);
+        }
+    });
+}
+
+} // namespace iden3math::hash
@@ -0,0 +1,87 @@
+#include <iden3math/merkle/batch.h>
+#include "cxx/parallel.h"
+#include "levels.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace iden3math::merkle {
+
+std::vector<bool> verify_paths_batch(const Fp254& root, std::span<const Fp254> leaves, std::span<const Path> paths, uint32_t threads) {
+    if (leaves.size() != paths.size()) {
+        throw std::invalid_argument("Number of leaves and paths mismatch");
+    }
+    // One hash per distinct (left, right) pair of a level, keyed on the Montgomery limbs of both
+    using Key = std::array<uint64_t, 8>;
+    struct Job {
+        Key    key;
+        size_t path;
+    };
+    std::vector<Fp254> nodes(leaves.begin(), leaves.end());
+    std::vector<Job> jobs;
+    std::vector<Fp254> pairs;
+    std::vector<Fp254> parents;
+    std::vector<size_t> slots(paths.size());
+    size_t depth = 0;
+    for (const auto& path : paths) {
+        depth = std::max(depth, path.siblings.size());
+    }
+    for (size_t l = 0; l < depth; ++l) {
+        jobs.clear();
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (l >= paths[i].siblings.size()) {
+                continue;
+            }
+            const bool right = 0 != ((paths[i].index >> l) & 1);
+            const auto& a = (right ? paths[i].siblings[l] : nodes[i]).mont();
+            const auto& b = (right ? nodes[i] : paths[i].siblings[l]).mont();
+            jobs.push_back({{a[0], a[1], a[2], a[3], b[0], b[1], b[2], b[3]}, i});
+        }
+        std::sort(jobs.begin(), jobs.end(), [](const Job& x, const Job& y) { return x.key < y.key; });
+        pairs.clear();
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            if (0 == j || jobs[j].key != jobs[j - 1].key) {
+                const auto& k = jobs[j].key;
+                pairs.push_back(Fp254::from_mont({k[0], k[1], k[2], k[3]}));
+                pairs.push_back(Fp254::from_mont({k[4], k[5], k[6], k[7]}));
+            }
+            slots[jobs[j].path] = pairs.size() / 2 - 1;
+        }
+        parents.resize(pairs.size() / 2);
+        hash_level(pairs, parents, threads);
+        for (const auto& job : jobs) {
+            nodes[job.path] = parents[slots[job.path]];
+        }
+    }
+    std::vector<bool> result(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        result[i] = root == nodes[i];
+    }
+    return result;
+}
+
+template <typename Tree>
+static std::vector<Path> generate(const Tree& tree, std::span<const uint64_t> indices, uint32_t threads) {
+    for (const auto index : indices) {
+        if (index >= tree.size()) {
+            throw std::out_of_range("Merkle tree leaf index out of range");
+        }
+    }
+    std::vector<Path> paths(indices.size());
+    parallel_for(indices.size(), threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            paths[i] = tree.path(indices[i]);
+        }
+    });
+    return paths;
+}
+
+std::vector<Path> generate_paths_batch(const MerkleTree& tree, std::span<const uint64_t> indices, uint32_t threads) {
+    return generate(tree, indices, threads);
+}
+
+std::vector<Path> generate_paths_batch(const MappedMerkleTree& tree, std::span<const uint64_t> indices, uint32_t threads) {
+    return generate(tree, indices, threads);
+}
+
+} // namespace iden3math::merkle
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <iden3math/fp254.h>
+#include <iden3math/hash/mimc.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Level-by-level node updates shared by the in-memory and the memory-mapped trees
+// level(l, count) returns the first count nodes of level l, sized to hold them
+
+namespace iden3math::merkle {
+
+// Parents of consecutive (left, right) children, large levels are split across threads
+void hash_level(std::span<const Fp254> children, std::span<Fp254> parents, uint32_t threads);
+
+// Leaf index was just set, recompute its ancestors, O(levels) hashes
+// A right child's sibling is the filled subtree on its left, a left child's sibling is still empty
+template <typename Level>
+void update_path(const std::vector<Fp254>& zeros, uint64_t index, Level level) {
+    const auto levels = static_cast<uint32_t>(zeros.size() - 1);
+    auto node = level(0, index + 1)[index];
+    for (uint32_t l = 0; l < levels; ++l, index >>= 1) {
+        node = 0 == (index & 1) ? hash::mimc_hash_pair(node, zeros[l]) : hash::mimc_hash_pair(level(l, index + 1)[index - 1], node);
+        level(l + 1, (index >> 1) + 1)[index >> 1] = node;
+    }
+}
+
+// Leaves [first, size) were just set, recompute every touched ancestor bottom-up
+// Parents with both children set hash straight from the level, an odd last child pairs with the empty subtree
+template <typename Level>
+void update_range(const std::vector<Fp254>& zeros, uint64_t first, uint64_t size, Level level, uint32_t threads) {
+    const auto levels = static_cast<uint32_t>(zeros.size() - 1);
+    for (uint32_t l = 0; l < levels; ++l) {
+        const auto children = level(l, size);
+        const auto parents = level(l + 1, (size + 1) / 2);
+        const auto full = size / 2;
+        const auto begin = first / 2;
+        hash_level(children.subspan(begin * 2, (full - begin) * 2), parents.subspan(begin, full - begin), threads);
+        if (full < parents.size()) {
+            parents[full] = hash::mimc_hash_pair(children[full * 2], zeros[l]);
+        }
+        first = begin;
+        size = parents.size();
+    }
+}
+
+// Siblings of leaf index in a tree of size leaves
+template <typename Level>
+std::vector<Fp254> siblings(const std::vector<Fp254>& zeros, uint64_t index, uint64_t size, Level level) {
+    const auto levels = static_cast<uint32_t>(zeros.size() - 1);
+    std::vector<Fp254> out;
+    out.reserve(levels);
+    for (uint32_t l = 0; l < levels; ++l, index >>= 1, size = (size + 1) / 2) {
+        const auto sibling = index ^ 1;
+        out.push_back(sibling < size ? level(l, size)[sibling] : zeros[l]);
+    }
+    return out;
+}
+
+} // namespace iden3math::merkle
@@ -0,0 +1,365 @@
+#include <iden3math/hash/keccak.h>
+#include <iden3math/hash/mimc.h>
+#include <iden3math/merkle/mapped_tree.h>
+#include "levels.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#if !defined(_WIN32)
+    #include <cerrno>
+    #include <filesystem>
+    #include <fcntl.h>
+    #include <sys/file.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace iden3math::merkle {
+
+static_assert(sizeof(Fp254) == 32 && std::is_trivially_copyable_v<Fp254>, "Nodes are mapped as raw Fp254");
+
+#if !defined(_WIN32)
+
+static constexpr char LOG_MAGIC[8] = {'I', '3', 'M', 'L', 'E', 'A', 'F', '2'};
+static constexpr char NODES_MAGIC[8] = {'I', '3', 'M', 'N', 'O', 'D', 'E', '1'};
+static constexpr size_t LOG_HEADER = 64;     // Magic, levels, zero leaf as 32 big-endian bytes
+static constexpr size_t NODES_HEADER = 4096; // Magic, levels, leaves reflected, zero leaf, one page to keep the levels aligned
+static constexpr size_t RECORD = 40;         // Leaf as 32 big-endian bytes, then its checksum
+static constexpr size_t LEAVES_PER_READ = 1 << 16;
+
+// Header fields, host byte order
+struct LogHeader {
+    char     magic[8];
+    uint32_t levels;
+    uint32_t reserved;
+    uint8_t  zero[32];
+};
+
+struct NodesHeader {
+    char     magic[8];
+    uint32_t levels;
+    uint32_t reserved;
+    uint64_t recorded; // Leaves of the log the levels reflect
+    Fp254    zero;
+};
+
+static_assert(sizeof(LogHeader) <= LOG_HEADER && sizeof(NodesHeader) <= NODES_HEADER);
+
+[[noreturn]] static void throw_errno(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+static void to_be_bytes(const Fp254& a, uint8_t* out) {
+    const auto limbs = a.limbs();
+    for (size_t i = 0; i < 32; ++i) {
+        out[31 - i] = static_cast<uint8_t>(limbs[i / 8] >> (i % 8 * 8));
+    }
+}
+
+static Fp254 from_be_bytes(const uint8_t* in) {
+    Fp254::Limbs limbs = {0, 0, 0, 0};
+    for (size_t i = 0; i < 32; ++i) {
+        limbs[i / 8] |= static_cast<uint64_t>(in[31 - i]) << (i % 8 * 8);
+    }
+    return Fp254::from_limbs(limbs);
+}
+
+// First 8 bytes of keccak256(index as 8 little-endian bytes, leaf bytes), written after the leaf
+// The index ties a record to its slot, zero-filled or stale blocks a crash left in the log do not pass
+static void seal_record(uint64_t index, uint8_t* record) {
+    uint8_t prefix[8];
+    for (size_t i = 0; i < sizeof(prefix); ++i) {
+        prefix[i] = static_cast<uint8_t>(index >> (i * 8));
+    }
+    hash::Keccak256 hasher;
+    hasher.update(prefix);
+    hasher.update({record, 32});
+    const auto digest = hasher.finalize();
+    std::memcpy(record + 32, digest.data(), RECORD - 32);
+}
+
+static bool record_intact(uint64_t index, const uint8_t* record) {
+    uint8_t sealed[RECORD];
+    std::memcpy(sealed, record, 32);
+    seal_record(index, sealed);
+    return 0 == std::memcmp(sealed + 32, record + 32, RECORD - 32);
+}
+
+static void write_all(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        const auto n = ::write(fd, data, size);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            throw_errno("Failed to append to the Merkle leaf log");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+static void read_all(int fd, uint8_t* data, size_t size, off_t offset) {
+    while (size > 0) {
+        const auto n = ::pread(fd, data, size, offset);
+        if (n <= 0) {
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            throw_errno("Failed to read the Merkle leaf log");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+}
+
+MappedMerkleTree::MappedMerkleTree(const std::string& dir, uint32_t levels, const Fp254& zero, uint32_t threads) : levels_(levels) {
+    if (0 == levels || levels > MAX_LEVELS) {
+        throw std::invalid_argument("Merkle tree levels must be 1 to " + std::to_string(MAX_LEVELS));
+    }
+    zeros_.reserve(levels + 1);
+    zeros_.push_back(zero);
+    for (uint32_t l = 0; l < levels; ++l) {
+        zeros_.push_back(hash::mimc_hash_pair(zeros_.back(), zeros_.back()));
+    }
+    std::filesystem::create_directories(dir);
+    const auto log_path = std::filesystem::path(dir) / "leaves.log";
+    const auto nodes_path = std::filesystem::path(dir) / "nodes.bin";
+    try {
+        // Leaf log, a torn last record is cut off
+        log_fd_ = ::open(log_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log_fd_ < 0) {
+            throw_errno("Failed to open " + log_path.string());
+        }
+        // One instance per directory, the lock goes away with the descriptor
+        if (0 != ::flock(log_fd_, LOCK_EX | LOCK_NB)) {
+            if (EWOULDBLOCK == errno) {
+                throw std::runtime_error(dir + " is already open by another MappedMerkleTree");
+            }
+            throw_errno("Failed to lock " + log_path.string());
+        }
+        struct stat st = {};
+        if (0 != ::fstat(log_fd_, &st)) {
+            throw_errno("Failed to stat " + log_path.string());
+        }
+        uint8_t header[LOG_HEADER] = {};
+        LogHeader expected = {};
+        std::memcpy(expected.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+        expected.levels = levels;
+        to_be_bytes(zero, expected.zero);
+        if (static_cast<size_t>(st.st_size) < LOG_HEADER) {
+            if (0 != ::ftruncate(log_fd_, 0)) {
+                throw_errno("Failed to truncate " + log_path.string());
+            }
+            std::memcpy(header, &expected, sizeof(expected));
+            write_all(log_fd_, header, sizeof(header));
+            st.st_size = LOG_HEADER;
+        } else {
+            read_all(log_fd_, header, sizeof(header), 0);
+            if (0 != std::memcmp(header, &expected, sizeof(expected))) {
+                throw std::runtime_error(log_path.string() + " belongs to a tree of other levels or zero leaf");
+            }
+        }
+        auto leaves = (static_cast<uint64_t>(st.st_size) - LOG_HEADER) / RECORD;
+        if (leaves > capacity()) {
+            throw std::runtime_error(log_path.string() + " holds more leaves than the tree");
+        }
+
+        // Nodes, sized for the full tree up front
+        nodes_fd_ = ::open(nodes_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (nodes_fd_ < 0) {
+            throw_errno("Failed to open " + nodes_path.string());
+        }
+        map_size_ = NODES_HEADER + ((uint64_t(2) << levels) - 1) * sizeof(Fp254);
+        if (0 != ::ftruncate(nodes_fd_, static_cast<off_t>(map_size_))) {
+            throw_errno("Failed to size " + nodes_path.string());
+        }
+        auto* map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, nodes_fd_, 0);
+        if (MAP_FAILED == map) {
+            throw_errno("Failed to map " + nodes_path.string());
+        }
+        map_ = static_cast<uint8_t*>(map);
+
+        // Nodes of other parameters or ahead of the log are rebuilt
+        auto& nodes = *reinterpret_cast<NodesHeader*>(map_);
+        const bool valid = 0 == std::memcmp(nodes.magic, NODES_MAGIC, sizeof(NODES_MAGIC)) && levels == nodes.levels &&
+                           zero == nodes.zero && nodes.recorded <= leaves;
+        const uint64_t recorded = valid ? nodes.recorded : 0;
+        // Records past the last sync() may hold anything the filesystem left, the log ends at the first broken one
+        std::vector<uint8_t> buffer;
+        for (uint64_t i = recorded; i < leaves; i += LEAVES_PER_READ) {
+            const auto n = std::min<uint64_t>(LEAVES_PER_READ, leaves - i);
+            buffer.resize(n * RECORD);
+            read_all(log_fd_, buffer.data(), buffer.size(), static_cast<off_t>(LOG_HEADER + i * RECORD));
+            for (uint64_t j = 0; j < n; ++j) {
+                if (!record_intact(i + j, buffer.data() + j * RECORD)) {
+                    leaves = i + j;
+                    break;
+                }
+            }
+        }
+        if (LOG_HEADER + leaves * RECORD != static_cast<uint64_t>(st.st_size) && 0 != ::ftruncate(log_fd_, static_cast<off_t>(LOG_HEADER + leaves * RECORD))) {
+            throw_errno("Failed to truncate " + log_path.string());
+        }
+        std::memcpy(nodes.magic, NODES_MAGIC, sizeof(NODES_MAGIC));
+        nodes.levels = levels;
+        nodes.reserved = 0;
+        nodes.zero = zero;
+        nodes.recorded = recorded;
+        size_ = leaves;
+        // Updates of leaves the log lost may have reached the last leaf's ancestors, its path is always recomputed
+        replay(std::min(recorded, 0 == leaves ? 0 : leaves - 1), threads);
+    } catch (...) {
+        if (nullptr != map_) {
+            ::munmap(map_, map_size_);
+        }
+        if (nodes_fd_ >= 0) {
+            ::close(nodes_fd_);
+        }
+        if (log_fd_ >= 0) {
+            ::close(log_fd_);
+        }
+        throw;
+    }
+}
+
+MappedMerkleTree::~MappedMerkleTree() {
+    try {
+        sync();
+    } catch (...) {
+        // Leaves past the last successful sync() are replayed from the log on the next open
+    }
+    ::munmap(map_, map_size_);
+    ::close(nodes_fd_);
+    ::close(log_fd_);
+}
+
+std::span<Fp254> MappedMerkleTree::level(uint32_t l) const {
+    const auto offset = NODES_HEADER + ((uint64_t(2) << levels_) - (uint64_t(2) << (levels_ - l))) * sizeof(Fp254);
+    return {reinterpret_cast<Fp254*>(map_ + offset), static_cast<size_t>(uint64_t(1) << (levels_ - l))};
+}
+
+// Load leaves [first, size_) of the log into level 0 and rehash their ancestors
+void MappedMerkleTree::replay(uint64_t first, uint32_t threads) {
+    if (first == size_) {
+        return;
+    }
+    std::vector<uint8_t> buffer;
+    const auto leaves = level(0);
+    for (uint64_t i = first; i < size_; i += LEAVES_PER_READ) {
+        const auto n = std::min<uint64_t>(LEAVES_PER_READ, size_ - i);
+        buffer.resize(n * RECORD);
+        read_all(log_fd_, buffer.data(), buffer.size(), static_cast<off_t>(LOG_HEADER + i * RECORD));
+        for (uint64_t j = 0; j < n; ++j) {
+            leaves[i + j] = from_be_bytes(buffer.data() + j * RECORD);
+        }
+    }
+    update_range(zeros_, first, size_, [this](uint32_t l, uint64_t count) { return level(l).first(count); }, threads);
+}
+
+void MappedMerkleTree::append_log(std::span<const Fp254> leaves) {
+    std::vector<uint8_t> bytes(leaves.size() * RECORD);
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        to_be_bytes(leaves[i], bytes.data() + i * RECORD);
+        seal_record(size_ + i, bytes.data() + i * RECORD);
+    }
+    try {
+        write_all(log_fd_, bytes.data(), bytes.size());
+    } catch (...) {
+        // Drop a partial append so the log stays in step with size_
+        (void)::ftruncate(log_fd_, static_cast<off_t>(LOG_HEADER + size_ * RECORD));
+        throw;
+    }
+}
+
+uint64_t MappedMerkleTree::insert(const Fp254& leaf) {
+    const auto index = size_;
+    if (capacity() == index) {
+        throw std::length_error("Merkle tree is full");
+    }
+    append_log({&leaf, 1});
+    level(0)[index] = leaf;
+    ++size_;
+    update_path(zeros_, index, [this](uint32_t l, uint64_t count) { return level(l).first(count); });
+    return index;
+}
+
+void MappedMerkleTree::insert(std::span<const Fp254> leaves, uint32_t threads) {
+    if (leaves.empty()) {
+        return;
+    }
+    if (leaves.size() > capacity() - size_) {
+        throw std::length_error("Merkle tree is full");
+    }
+    append_log(leaves);
+    const auto first = size_;
+    std::copy(leaves.begin(), leaves.end(), level(0).begin() + static_cast<std::ptrdiff_t>(first));
+    size_ += leaves.size();
+    update_range(zeros_, first, size_, [this](uint32_t l, uint64_t count) { return level(l).first(count); }, threads);
+}
+
+void MappedMerkleTree::sync() {
+    // The log first, nodes.bin must never record leaves the log could lose
+    if (0 != ::fdatasync(log_fd_)) {
+        throw_errno("Failed to flush the Merkle leaf log");
+    }
+    if (0 != ::msync(map_ + NODES_HEADER, map_size_ - NODES_HEADER, MS_SYNC)) {
+        throw_errno("Failed to flush the Merkle nodes");
+    }
+    reinterpret_cast<NodesHeader*>(map_)->recorded = size_;
+    if (0 != ::msync(map_, NODES_HEADER, MS_SYNC)) {
+        throw_errno("Failed to flush the Merkle nodes");
+    }
+}
+
+#else
+
+MappedMerkleTree::MappedMerkleTree(const std::string&, uint32_t levels, const Fp254&, uint32_t) : levels_(levels) {
+    throw std::runtime_error("MappedMerkleTree needs POSIX mmap");
+}
+
+MappedMerkleTree::~MappedMerkleTree() = default;
+
+std::span<Fp254> MappedMerkleTree::level(uint32_t) const {
+    return {};
+}
+
+void MappedMerkleTree::replay(uint64_t, uint32_t) {}
+
+void MappedMerkleTree::append_log(std::span<const Fp254>) {}
+
+uint64_t MappedMerkleTree::insert(const Fp254&) {
+    return 0;
+}
+
+void MappedMerkleTree::insert(std::span<const Fp254>, uint32_t) {}
+
+void MappedMerkleTree::sync() {}
+
+#endif
+
+Path MappedMerkleTree::path(uint64_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("Merkle tree leaf index out of range");
+    }
+    Path path;
+    path.index = index;
+    path.siblings = siblings(zeros_, index, size_, [this](uint32_t l, uint64_t count) { return level(l).first(count); });
+    return path;
+}
+
+Fp254 MappedMerkleTree::root() const {
+    return 0 == size_ ? zeros_.back() : level(levels_)[0];
+}
+
+const Fp254& MappedMerkleTree::leaf(uint64_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("Merkle tree leaf index out of range");
+    }
+    return level(0)[index];
+}
+
+} // namespace iden3math::merkle
@@ -0,0 +1,102 @@
+#include <iden3math/hash/mimc.h>
+#include <iden3math/merkle/tree.h>
+#include "cxx/parallel.h"
+#include "levels.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace iden3math::merkle {
+
+void hash_level(std::span<const Fp254> children, std::span<Fp254> parents, uint32_t threads) {
+    static constexpr size_t MIN_PARENTS_PER_THREAD = 256;
+    if (children.size() != parents.size() * 2) {
+        throw std::invalid_argument("Number of children and parents mismatch");
+    }
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, parents.size() / MIN_PARENTS_PER_THREAD));
+    parallel_for(parents.size(), threads, [&](size_t first, size_t last) {
+        hash::mimc_hash_pairs(children.subspan(first * 2, (last - first) * 2), parents.subspan(first, last - first));
+    });
+}
+
+MerkleTree::MerkleTree(uint32_t levels, const Fp254& zero, size_t history) : levels_(levels), history_(history) {
+    if (0 == levels || levels > MAX_LEVELS) {
+        throw std::invalid_argument("Merkle tree levels must be 1 to " + std::to_string(MAX_LEVELS));
+    }
+    if (0 == history) {
+        throw std::invalid_argument("Merkle tree root history must not be empty");
+    }
+    zeros_.reserve(levels + 1);
+    zeros_.push_back(zero);
+    for (uint32_t l = 0; l < levels; ++l) {
+        zeros_.push_back(hash::mimc_hash_pair(zeros_.back(), zeros_.back()));
+    }
+    nodes_.resize(levels + 1);
+    roots_.reserve(history);
+    roots_.push_back(zeros_.back());
+}
+
+std::span<Fp254> MerkleTree::level(uint32_t l, uint64_t count) {
+    if (nodes_[l].size() < count) {
+        nodes_[l].resize(count);
+    }
+    return std::span(nodes_[l]).first(count);
+}
+
+void MerkleTree::push_root(const Fp254& root) {
+    if (roots_.size() < history_) {
+        roots_.push_back(root);
+        current_ = roots_.size() - 1;
+    } else {
+        current_ = (current_ + 1) % history_;
+        roots_[current_] = root;
+    }
+}
+
+uint64_t MerkleTree::insert(const Fp254& leaf) {
+    const auto index = size();
+    if (capacity() == index) {
+        throw std::length_error("Merkle tree is full");
+    }
+    nodes_[0].push_back(leaf);
+    update_path(zeros_, index, [this](uint32_t l, uint64_t count) { return level(l, count); });
+    push_root(nodes_[levels_][0]);
+    return index;
+}
+
+void MerkleTree::insert(std::span<const Fp254> leaves, uint32_t threads) {
+    if (leaves.empty()) {
+        return;
+    }
+    if (leaves.size() > capacity() - size()) {
+        throw std::length_error("Merkle tree is full");
+    }
+    const auto first = size();
+    nodes_[0].insert(nodes_[0].end(), leaves.begin(), leaves.end());
+    update_range(zeros_, first, size(), [this](uint32_t l, uint64_t count) { return level(l, count); }, threads);
+    push_root(nodes_[levels_][0]);
+}
+
+Path MerkleTree::path(uint64_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("Merkle tree leaf index out of range");
+    }
+    Path path;
+    path.index = index;
+    path.siblings = siblings(zeros_, index, size(), [this](uint32_t l, uint64_t) { return std::span<const Fp254>(nodes_[l]); });
+    return path;
+}
+
+bool MerkleTree::is_known_root(const Fp254& root) const {
+    return std::find(roots_.begin(), roots_.end(), root) != roots_.end();
+}
+
+Fp254 MerkleTree::compute_root(const Fp254& leaf, const Path& path) {
+    auto node = leaf;
+    for (size_t l = 0; l < path.siblings.size(); ++l) {
+        node = 0 == ((path.index >> l) & 1) ? hash::mimc_hash_pair(node, path.siblings[l]) : hash::mimc_hash_pair(path.siblings[l], node);
+    }
+    return node;
+}
+
+} // namespace iden3math::merkle
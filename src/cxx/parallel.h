@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iden3math {
+
+/**
+ * Split [0, n) into contiguous ranges run by job(first, last) on up to the given number of threads, the calling
+ * thread runs the first range. Every started thread is joined before returning, then the first exception thrown by
+ * a job, or by starting a thread (std::system_error), is rethrown
+ */
+template <typename F>
+void parallel_for(size_t n, uint32_t threads, const F& job) {
+    threads = std::max<uint32_t>(1, std::min<uint32_t>(threads, static_cast<uint32_t>(std::min<size_t>(n, UINT32_MAX))));
+    if (1 == threads) {
+        job(size_t(0), n);
+        return;
+    }
+    std::mutex mutex;
+    std::exception_ptr error;
+    const auto run = [&](size_t first, size_t last) {
+        try {
+            job(first, last);
+        } catch (...) {
+            std::lock_guard lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::shared_ptr<std::thread>> workers;
+    try {
+        for (uint32_t t = 1; t < threads; ++t) {
+            workers.emplace_back(std::make_shared<std::thread>(run, n * t / threads, n * (t + 1) / threads));
+        }
+    } catch (...) {
+        std::lock_guard lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+    bool failed;
+    {
+        std::lock_guard lock(mutex);
+        failed = static_cast<bool>(error);
+    }
+    if (!failed) {
+        run(0, n / threads);
+    }
+    for (auto& worker : workers) {
+        worker->join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace iden3math
@@ -1,6 +1,7 @@
 #ifdef IDEN3MATH_BUILD_PY
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "pyc/helper_py.h"
 #include <iden3math/ec/babyjub.h>
@@ -9,6 +10,13 @@ namespace py = pybind11;
 
 using namespace iden3math;
 
+typedef py::array_t<uint8_t, py::array::c_style> ByteArray;
+
+// Coordinates travel as 32-byte rows in the given endian
+static void write_coordinate(const BigInt& v, Endian endian, uint8_t* out) {
+    v.to_bytes_fixed(std::span<uint8_t>(out, 32), endian);
+}
+
 void init_ec_babyjub(py::module_& m) {
     m.def_submodule("babyjub")
     .def("prime", &ec::babyjub::prime, "Returns the prime number of the BabyJubjub curve.")
@@ -17,12 +25,80 @@ void init_ec_babyjub(py::module_& m) {
     .def("sub_group_order", &ec::babyjub::sub_group_order, "Returns the order of the subgroup of points on the BabyJubjub curve.")
     .def("zero", &ec::babyjub::zero, "Returns the zero point (identity element) of the BabyJubjub curve.")
     .def("generator", &ec::babyjub::generator, "Returns the generator point of the BabyJubjub curve.")
-    .def("add", &ec::babyjub::add, py::arg("a"), py::arg("b"), "Adds two points on the BabyJubjub curve.")
-    .def("mul_scalar", &ec::babyjub::mul_scalar, py::arg("p"), py::arg("k"), "Multiplies a point on the BabyJubjub curve by a scalar.")
-    .def("in_sub_group", &ec::babyjub::in_sub_group, py::arg("p"), "Checks if a point is in the subgroup of the BabyJubjub curve.")
-    .def("in_curve", &ec::babyjub::in_curve, py::arg("p"), "Checks if a point is on the BabyJubjub curve.")
-    .def("compress", &ec::babyjub::compress, py::arg("p"), py::arg("endian"), "Compresses a point on the BabyJubjub curve into a byte vector.")
-    .def("decompress", &ec::babyjub::decompress, py::arg("packed"), py::arg("endian"), "Decompresses a byte vector into a point on the BabyJubjub curve.")
+    .def("add", py::overload_cast<const ec::Point&, const ec::Point&>(&ec::babyjub::add), py::arg("a"), py::arg("b"), py::call_guard<py::gil_scoped_release>(), "Adds two points on the BabyJubjub curve.")
+    .def("mul_scalar", py::overload_cast<const ec::Point&, const BigInt&>(&ec::babyjub::mul_scalar), py::arg("p"), py::arg("k"), py::call_guard<py::gil_scoped_release>(), "Multiplies a point on the BabyJubjub curve by a scalar.")
+    .def("mul_scalar_wnaf", py::overload_cast<const ec::Point&, const BigInt&, uint32_t>(&ec::babyjub::mul_scalar_wnaf), py::arg("p"), py::arg("k"), py::arg("width") = 4, py::call_guard<py::gil_scoped_release>(), "Multiplies a point on the BabyJubjub curve by a scalar using a signed window (wNAF).")
+    .def("mul_scalar_ct", py::overload_cast<const ec::Point&, const BigInt&>(&ec::babyjub::mul_scalar_ct), py::arg("p"), py::arg("k"), py::call_guard<py::gil_scoped_release>(), "Multiplies a point on the BabyJubjub curve by a secret scalar in constant time.")
+    .def("mul_base", &ec::babyjub::mul_base, py::arg("k"), py::call_guard<py::gil_scoped_release>(), "Multiplies the generator point of the BabyJubjub curve by a scalar using a precomputed table.")
+    .def("msm", [](const std::vector<ec::Point>& points, const std::vector<BigInt>& scalars, uint32_t threads) { return ec::babyjub::msm(points, scalars, threads); }, py::arg("points"), py::arg("scalars"), py::arg("threads") = 1, py::call_guard<py::gil_scoped_release>(), "Computes the sum of scalar multiplications of points on the BabyJubjub curve.")
+    .def("in_sub_group", &ec::babyjub::in_sub_group, py::arg("p"), py::call_guard<py::gil_scoped_release>(), "Checks if a point is in the subgroup of the BabyJubjub curve.")
+    .def("in_curve", &ec::babyjub::in_curve, py::arg("p"), py::call_guard<py::gil_scoped_release>(), "Checks if a point is on the BabyJubjub curve.")
+    .def("compress", &ec::babyjub::compress, py::arg("p"), py::arg("endian"), py::call_guard<py::gil_scoped_release>(), "Compresses a point on the BabyJubjub curve into a byte vector.")
+    .def("decompress", &ec::babyjub::decompress, py::arg("packed"), py::arg("endian"), py::call_guard<py::gil_scoped_release>(), "Decompresses a byte vector into a point on the BabyJubjub curve.")
+    .def("decompress_batch", [](const ByteArray& packed, Endian endian, uint32_t threads) {
+        if (2 != packed.ndim() || 32 != packed.shape(1)) {
+            throw py::value_error("Packed points must be an (n, 32) uint8 array");
+        }
+        const auto rows = static_cast<size_t>(packed.shape(0));
+        ByteArray xy({rows, size_t(2), size_t(32)});
+        py::array_t<bool> valid(static_cast<py::ssize_t>(rows));
+        std::span<const std::array<uint8_t, 32>> arrays(reinterpret_cast<const std::array<uint8_t, 32>*>(packed.data()), rows);
+        auto* coordinates = xy.mutable_data();
+        auto* flags = valid.mutable_data();
+        {
+            py::gil_scoped_release release;
+            parallel_rows(rows, threads, [&](size_t first, size_t last) {
+                const auto points = ec::babyjub::decompress_batch(arrays.subspan(first, last - first), endian);
+                for (size_t i = first; i < last; ++i) {
+                    const auto& p = points[i - first];
+                    flags[i] = p.has_value();
+                    write_coordinate(p ? p->x : BigInt(0), endian, coordinates + i * 64);
+                    write_coordinate(p ? p->y : BigInt(0), endian, coordinates + i * 64 + 32);
+                }
+            });
+        }
+        return py::make_tuple(xy, valid);
+    }, py::arg("packed").noconvert(), py::arg("endian"), py::arg("threads") = 1, "Decompresses an (n, 32) uint8 array into an (n, 2, 32) uint8 array of (x, y) and an (n,) bool array of validity.")
+    .def("decompress_batch", [](std::span<const uint8_t> packed, Endian endian, uint32_t threads) {
+        if (0 != packed.size() % 32) {
+            throw py::value_error("Packed points must be a multiple of 32 bytes");
+        }
+        // Read in place, std::array<uint8_t, 32> has the layout of 32 contiguous bytes
+        std::span<const std::array<uint8_t, 32>> arrays(reinterpret_cast<const std::array<uint8_t, 32>*>(packed.data()), packed.size() / 32);
+        py::gil_scoped_release release;
+        return ec::babyjub::decompress_batch(arrays, endian, threads);
+    }, py::arg("packed"), py::arg("endian"), py::arg("threads") = 1, "Decompresses a contiguous buffer of 32-byte points on the BabyJubjub curve with a single field inversion per thread.")
+    .def("decompress_batch", [](const std::vector<ByteVec1D>& packed, Endian endian, uint32_t threads) {
+        std::vector<std::array<uint8_t, 32>> arrays(packed.size());
+        for (size_t i = 0; i < packed.size(); ++i) {
+            if (arrays[i].size() != packed[i].size()) {
+                throw py::value_error("Packed point must be 32 bytes");
+            }
+            std::copy(packed[i].begin(), packed[i].end(), arrays[i].begin());
+        }
+        py::gil_scoped_release release;
+        return ec::babyjub::decompress_batch(arrays, endian, threads);
+    }, py::arg("packed"), py::arg("endian"), py::arg("threads") = 1, "Decompresses 32-byte vectors into points on the BabyJubjub curve with a single field inversion per thread.")
+    .def("compress_batch", [](const py::array_t<uint8_t, py::array::c_style | py::array::forcecast>& xy, Endian endian, uint32_t threads) {
+        if (3 != xy.ndim() || 2 != xy.shape(1) || 32 != xy.shape(2)) {
+            throw py::value_error("Points must be an (n, 2, 32) uint8 array of (x, y)");
+        }
+        const auto rows = static_cast<size_t>(xy.shape(0));
+        ByteArray out({rows, size_t(32)});
+        const auto* coordinates = xy.data();
+        auto* packed = out.mutable_data();
+        {
+            py::gil_scoped_release release;
+            parallel_rows(rows, threads, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    const ec::Point p(BigInt::from_bytes(std::span(coordinates + i * 64, 32), endian), BigInt::from_bytes(std::span(coordinates + i * 64 + 32, 32), endian));
+                    const auto bytes = ec::babyjub::compress(p, endian);
+                    std::copy(bytes.begin(), bytes.end(), packed + i * 32);
+                }
+            });
+        }
+        return out;
+    }, py::arg("points"), py::arg("endian"), py::arg("threads") = 1, "Compresses an (n, 2, 32) uint8 array of (x, y) into an (n, 32) uint8 array.")
     ;
 }
 
@@ -21,6 +21,7 @@ void init_fp1(py::module_& m) {
     .def("square", &Fp1::square, py::arg("a"), "Square an integer in the field.")
     .def("sqrt", &Fp1::sqrt, py::arg("a"), "Compute the square root of an integer in the field. Returns None if 'a' does not have a square root.")
     .def("mod_inv", &Fp1::mod_inv, py::arg("a"), "Compute the modular inverse of an integer in the field. Returns None if 'a' does not have a modular inverse.")
+    .def("batch_inv", [](const Fp1& f, std::vector<BigInt> a) { f.batch_inv(a); return a; }, py::arg("a"), "Compute the modular inverses of a list of integers with a single inversion. Integers without a modular inverse map to 0.")
     .def("neg", &Fp1::neg, py::arg("a"), "Negate an integer in the field.")
     .def("has_sqrt", &Fp1::has_sqrt, py::arg("a"), "Check if an integer has a square root in the field.")
     ;
@@ -9,16 +9,39 @@ namespace py = pybind11;
 using namespace iden3math;
 
 void init_hash_blake(py::module_& m) {
+    // The methods mutate the hasher, they keep the GIL so threads sharing one hasher cannot interleave
+    py::class_<hash::Blake256>(m, "Blake256")
+    .def(py::init<>(), "Create an incremental BLAKE256 hasher.")
+    .def("update", [](hash::Blake256& self, std::span<const uint8_t> bytes) {
+            self.update(bytes);
+        },
+        py::arg("data"),
+        "Absorb more bytes, any contiguous buffer is read in place."
+    )
+    .def("update", [](hash::Blake256& self, const std::string& text) {
+            self.update({reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+        },
+        py::arg("data"),
+        "Absorb the bytes of a string."
+    )
+    .def("finalize", [](hash::Blake256& self) -> ByteVec1D {
+            const auto digest = self.finalize();
+            return {digest.begin(), digest.end()};
+        },
+        "Return the digest of everything absorbed so far and reset the hasher."
+    )
+    .def("reset", &hash::Blake256::reset, "Discard everything absorbed so far.")
+    ;
     m.def("blake256", [](const ByteVec1D& bytes) -> ByteVec1D {
             return hash::blake256(bytes);
         },
-        py::arg("bytes"),
+        py::arg("bytes"), py::call_guard<py::gil_scoped_release>(),
         "Compute BLAKE256 hash of a byte array."
     )
     .def("blake256", [](const std::string& text) -> ByteVec1D {
             return hash::blake256(text);
         },
-        py::arg("text"),
+        py::arg("text"), py::call_guard<py::gil_scoped_release>(),
         "Compute BLAKE256 hash of a text string."
     )
     ;
@@ -1,6 +1,7 @@
 #ifdef IDEN3MATH_BUILD_PY
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include "pyc/helper_py.h"
 #include <iden3math/hash/keccak.h>
 
@@ -8,13 +9,39 @@ namespace py = pybind11;
 
 using namespace iden3math;
 
+static ByteVec1D to_bytes(const std::array<uint8_t, 32>& digest) {
+    return {digest.begin(), digest.end()};
+}
+
 void init_hash_keccak(py::module_& m) {
-    m.def("keccak256", [](const ByteVec1D& bytes) -> ByteVec1D {
-            ByteVec1D digest;
-            hash::keccak256(bytes, digest);
-            return digest;
+    // The methods mutate the hasher, they keep the GIL so threads sharing one hasher cannot interleave
+    py::class_<hash::Keccak256>(m, "Keccak256")
+    .def(py::init<>(), "Create an incremental Keccak256 hasher.")
+    .def("update", [](hash::Keccak256& self, std::span<const uint8_t> bytes) {
+            self.update(bytes);
         },
-        py::arg("bytes"),
+        py::arg("data"),
+        "Absorb more bytes, any contiguous buffer is read in place."
+    )
+    .def("update", [](hash::Keccak256& self, const std::string& text) {
+            self.update({reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+        },
+        py::arg("data"),
+        "Absorb the bytes of a string."
+    )
+    .def("finalize", [](hash::Keccak256& self) -> ByteVec1D {
+            return to_bytes(self.finalize());
+        },
+        "Return the digest of everything absorbed so far and reset the hasher."
+    )
+    .def("reset", &hash::Keccak256::reset, "Discard everything absorbed so far.")
+    ;
+    m.def("keccak256", [](std::span<const uint8_t> bytes) -> ByteVec1D {
+            hash::Keccak256 hasher;
+            hasher.update(bytes);
+            return to_bytes(hasher.finalize());
+        },
+        py::arg("bytes"), py::call_guard<py::gil_scoped_release>(),
         "Compute Keccak256 hash of a byte array."
     )
     .def("keccak256", [](const std::string& text) -> ByteVec1D {
@@ -22,7 +49,7 @@ void init_hash_keccak(py::module_& m) {
             hash::keccak256(text, digest);
             return digest;
         },
-        py::arg("text"),
+        py::arg("text"), py::call_guard<py::gil_scoped_release>(),
         "Compute Keccak256 hash of a string."
     )
     .def("keccak256", [](const BigInt& number) -> ByteVec1D {
@@ -30,9 +57,34 @@ void init_hash_keccak(py::module_& m) {
             hash::keccak256(number, digest);
             return digest;
         },
-        py::arg("number"),
+        py::arg("number"), py::call_guard<py::gil_scoped_release>(),
         "Compute Keccak256 hash of a number."
     )
+    .def("keccak256_batch", [](const py::array_t<uint8_t, py::array::c_style | py::array::forcecast>& data, uint32_t threads) {
+            if (2 != data.ndim()) {
+                throw py::value_error("Input must be a 2D uint8 array, one message per row");
+            }
+            const auto rows = static_cast<size_t>(data.shape(0));
+            const auto width = static_cast<size_t>(data.shape(1));
+            py::array_t<uint8_t> out({rows, size_t(32)});
+            const auto* in = data.data();
+            auto* digests = out.mutable_data();
+            {
+                py::gil_scoped_release release;
+                parallel_rows(rows, threads, [=](size_t first, size_t last) {
+                    std::vector<std::span<const uint8_t>> inputs;
+                    inputs.reserve(last - first);
+                    for (size_t i = first; i < last; ++i) {
+                        inputs.emplace_back(in + i * width, width);
+                    }
+                    hash::keccak256_many(inputs, {reinterpret_cast<std::array<uint8_t, 32>*>(digests) + first, last - first});
+                });
+            }
+            return out;
+        },
+        py::arg("data"), py::arg("threads") = 1,
+        "Compute Keccak256 hash of every row of a 2D uint8 array, returns an (n, 32) uint8 array."
+    )
     ;
 }
 
@@ -1,6 +1,7 @@
 #ifdef IDEN3MATH_BUILD_PY
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "pyc/helper_py.h"
 #include <iden3math/hash/mimc.h>
@@ -18,8 +19,30 @@ void init_hash_mimc(py::module_& m) {
         },
         py::arg("preimages"), py::arg("outputs"), py::arg("key"),
         py::arg("preimage_endian") = BE, py::arg("key_endian") = BE, py::arg("digest_endian") = BE,
+        py::call_guard<py::gil_scoped_release>(),
         "Compute MiMC sponge hash for multiple preimages with an optional key."
     )
+    .def("mimc_sponge_batch", [](const py::array_t<uint8_t, py::array::c_style | py::array::forcecast>& preimages, size_t outputs, const ByteVec1D& key,
+                                 Endian preimage_endian, Endian key_endian, Endian digest_endian, uint32_t threads) {
+            if ((2 != preimages.ndim() && 3 != preimages.ndim()) || 32 != preimages.shape(preimages.ndim() - 1)) {
+                throw py::value_error("Preimages must be an (n, 32) or (n, k, 32) uint8 array");
+            }
+            // (n, 32) is one preimage per sponge
+            const auto rows = static_cast<size_t>(preimages.shape(0));
+            const auto count = 3 == preimages.ndim() ? static_cast<size_t>(preimages.shape(1)) : 1;
+            py::array_t<uint8_t> out({rows, outputs, size_t(32)});
+            const std::span in(reinterpret_cast<const std::array<uint8_t, 32>*>(preimages.data()), rows * count);
+            const std::span digests(reinterpret_cast<std::array<uint8_t, 32>*>(out.mutable_data()), rows * outputs);
+            {
+                py::gil_scoped_release release;
+                hash::mimc_sponge_batch(in, count, outputs, key, digests, preimage_endian, key_endian, digest_endian, threads);
+            }
+            return out;
+        },
+        py::arg("preimages"), py::arg("outputs") = 1, py::arg("key") = ByteVec1D(),
+        py::arg("preimage_endian") = BE, py::arg("key_endian") = BE, py::arg("digest_endian") = BE, py::arg("threads") = 1,
+        "Compute MiMC sponge hash of every row of an (n, 32) or (n, k, 32) uint8 array, returns an (n, outputs, 32) uint8 array."
+    )
     ;
 }
 
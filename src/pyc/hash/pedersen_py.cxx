@@ -14,7 +14,7 @@ void init_hash_pedersen(py::module_& m) {
             hash::pedersen(preimage, digest);
             return digest;
         },
-        py::arg("preimage"),
+        py::arg("preimage"), py::call_guard<py::gil_scoped_release>(),
         "Compute the Pedersen hash of the given preimage."
     );
 }
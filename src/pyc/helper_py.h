@@ -5,50 +5,181 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <iden3math/bigint.h>
+#include "cxx/parallel.h"
+#include <array>
+#include <span>
+#include <vector>
 
 namespace py = pybind11;
 
 using namespace iden3math;
 
+// Split [0, n) into contiguous ranges run by job(first, last) on up to the given number of threads
+// Meant for batch bindings running with the GIL released, job must not touch Python objects
+// Failing to start a thread or an exception thrown by job is rethrown after the started threads joined
+template <typename F>
+inline void parallel_rows(size_t n, uint32_t threads, F job) {
+    parallel_for(n, threads, job);
+}
+
 namespace pybind11::detail {
 
+// Python int <-> BigInt through little-endian bytes, linear in the size instead of going through a decimal string
 template <>
 class type_caster<BigInt> {
     PYBIND11_TYPE_CASTER(BigInt, _("BigInt"));
     bool load(handle src, bool) {
         auto v = py::cast<py::int_>(src);
-        auto s = py::str(v);
-        value = {s, 10};
+        // Two's complement, one byte wider than the magnitude for the sign bit
+#if PY_VERSION_HEX >= 0x030D0000
+        const auto size = PyLong_AsNativeBytes(v.ptr(), nullptr, 0, Py_ASNATIVEBYTES_LITTLE_ENDIAN);
+        if (size < 0) {
+            throw py::error_already_set();
+        }
+        const auto len = static_cast<size_t>(size);
+#else
+        const auto bits = _PyLong_NumBits(v.ptr());
+        if (static_cast<size_t>(-1) == bits && PyErr_Occurred()) {
+            throw py::error_already_set();
+        }
+        const auto len = bits / 8 + 1;
+#endif
+        std::array<uint8_t, 64> small;
+        std::vector<uint8_t> large;
+        std::span<uint8_t> buf(small.data(), len);
+        if (len > small.size()) {
+            large.resize(len);
+            buf = large;
+        }
+#if PY_VERSION_HEX >= 0x030D0000
+        if (PyLong_AsNativeBytes(v.ptr(), buf.data(), static_cast<Py_ssize_t>(len), Py_ASNATIVEBYTES_LITTLE_ENDIAN) < 0) {
+            throw py::error_already_set();
+        }
+#else
+        if (_PyLong_AsByteArray(reinterpret_cast<PyLongObject*>(v.ptr()), buf.data(), len, 1, 1) < 0) {
+            throw py::error_already_set();
+        }
+#endif
+        const bool negative = 0 != len && (buf[len - 1] & 0x80);
+        if (negative) {
+            // Magnitude of a negative two's complement value, invert then add one
+            bool carry = true;
+            for (auto& byte : buf) {
+                byte = static_cast<uint8_t>(~byte + (carry ? 1 : 0));
+                carry = carry && 0 == byte;
+            }
+        }
+        value = BigInt::from_bytes(buf, LE);
+        if (negative) {
+            value = -value;
+        }
         return true;
     }
     static handle cast(const BigInt& v, return_value_policy, handle) {
-        return py::int_(py::str(v.str(10))).release();
+        const auto len = v.bytes_size();
+        std::array<uint8_t, 64> small;
+        std::vector<uint8_t> large;
+        std::span<uint8_t> buf(small.data(), len);
+        if (len > small.size()) {
+            large.resize(len);
+            buf = large;
+        }
+        v.to_bytes_fixed(buf, LE); // Magnitude
+#if PY_VERSION_HEX >= 0x030D0000
+        auto r = py::reinterpret_steal<py::object>(PyLong_FromUnsignedNativeBytes(buf.data(), len, Py_ASNATIVEBYTES_LITTLE_ENDIAN));
+#else
+        auto r = py::reinterpret_steal<py::object>(_PyLong_FromByteArray(buf.data(), len, 1, 0));
+#endif
+        if (!r) {
+            throw py::error_already_set();
+        }
+        if (v < 0) {
+            r = py::reinterpret_steal<py::object>(PyNumber_Negative(r.ptr()));
+            if (!r) {
+                throw py::error_already_set();
+            }
+        }
+        return r.release();
+    }
+};
+
+// C-contiguous Python buffer held for the duration of a call, bytes, bytearray, memoryview, numpy arrays, ...
+class PyBufferView final {
+public:
+    PyBufferView() = default;
+    PyBufferView(const PyBufferView&) = delete;
+    PyBufferView& operator=(const PyBufferView&) = delete;
+    ~PyBufferView() { release(); }
+
+    bool acquire(handle src) {
+        release();
+        if (!PyObject_CheckBuffer(src.ptr())) {
+            return false;
+        }
+        if (0 != PyObject_GetBuffer(src.ptr(), &view_, PyBUF_C_CONTIGUOUS)) {
+            PyErr_Clear();
+            return false;
+        }
+        held_ = true;
+        return true;
+    }
+
+    [[nodiscard]] std::span<const uint8_t> bytes() const {
+        if (!held_) {
+            return {};
+        }
+        return {static_cast<const uint8_t*>(view_.buf), static_cast<size_t>(view_.len)};
+    }
+
+private:
+    void release() {
+        if (held_) {
+            PyBuffer_Release(&view_);
+            held_ = false;
+        }
     }
+
+    Py_buffer view_ = {};
+    bool held_ = false;
 };
 
+// The C++ side owns a vector, so the buffer is copied exactly once
 template <>
 class type_caster<ByteVec1D> {
     PYBIND11_TYPE_CASTER(ByteVec1D, _("ByteVec1D"));
     bool load(handle src, bool) {
-        if (PyByteArray_Check(src.ptr())) {
-            auto* data = reinterpret_cast<Byte*>(PyByteArray_AsString(src.ptr()));
-            auto len = PyByteArray_Size(src.ptr());
-            value = ByteVec1D(data, data + len);
-            return true;
+        PyBufferView buffer;
+        if (!buffer.acquire(src)) {
+            return false;
         }
-        if (PyBytes_Check(src.ptr())) {
-            auto* data = reinterpret_cast<Byte*>(PyBytes_AsString(src.ptr()));
-            auto len = PyBytes_Size(src.ptr());
-            value = ByteVec1D(data, data + len);
-            return true;
-        }
-        return false;
+        const auto bytes = buffer.bytes();
+        value.assign(bytes.begin(), bytes.end());
+        return true;
     }
     static handle cast(const ByteVec1D& v, return_value_policy, handle) {
         return py::bytearray(reinterpret_cast<const char*>(v.data()), v.size()).release();
     }
 };
 
+// Borrows the Python buffer without copying, the view stays valid until the bound call returns
+template <>
+class type_caster<std::span<const uint8_t>> {
+    PYBIND11_TYPE_CASTER(std::span<const uint8_t>, _("Buffer"));
+    bool load(handle src, bool) {
+        if (!buffer_.acquire(src)) {
+            return false;
+        }
+        value = buffer_.bytes();
+        return true;
+    }
+    static handle cast(std::span<const uint8_t> v, return_value_policy, handle) {
+        return py::bytearray(reinterpret_cast<const char*>(v.data()), v.size()).release();
+    }
+
+private:
+    PyBufferView buffer_;
+};
+
 } // namespace pybind11::detail
 
 #endif
@@ -1,7 +1,9 @@
 """
 This module provides type annotations for the BabyJubjub elliptic curve operations.
 """
-from typing import Union
+from typing import Optional, Union, overload
+
+import numpy as np
 
 
 def prime() -> int:
@@ -72,6 +74,50 @@ def mul_scalar(p: 'Point', k: int) -> 'Point':
     """
     ...
 
+def mul_scalar_wnaf(p: 'Point', k: int, width: int = 4) -> 'Point':
+    """
+    Multiplies a point on the BabyJubjub curve by a scalar using a signed window (wNAF).
+    
+    :param p: The point to multiply.
+    :param k: The scalar value.
+    :param width: The window width, in [2, 8].
+    :return: The resulting point after multiplication.
+    """
+    ...
+
+def mul_scalar_ct(p: 'Point', k: int) -> 'Point':
+    """
+    Multiplies a point on the BabyJubjub curve by a secret scalar in constant time.
+    The point must be on the curve, the scalar is reduced modulo the group order.
+    
+    :param p: The point to multiply.
+    :param k: The scalar value.
+    :return: The resulting point after multiplication.
+    """
+    ...
+
+def mul_base(k: int) -> 'Point':
+    """
+    Multiplies the generator point of the BabyJubjub curve by a scalar using a precomputed table.
+    The scalar is reduced modulo the group order.
+    
+    :param k: The scalar value.
+    :return: The resulting point after multiplication.
+    """
+    ...
+
+def msm(points: list['Point'], scalars: list[int], threads: int = 1) -> 'Point':
+    """
+    Computes the sum of scalar multiplications of points on the BabyJubjub curve (multi-scalar multiplication).
+    The window size is chosen from the number of points.
+    
+    :param points: The points to multiply.
+    :param scalars: The scalar values, one per point.
+    :param threads: The number of threads to spread the windows across.
+    :return: The sum of scalars[i] * points[i].
+    """
+    ...
+
 def in_sub_group(p: 'Point') -> bool:
     """
     Checks if a point is in the subgroup of the BabyJubjub curve.
@@ -100,7 +146,7 @@ def compress(p: 'Point', endian: 'Endian') -> bytearray:
     """
     ...
 
-def decompress(packed: Union[bytes, bytearray], endian: 'Endian') -> 'Point':
+def decompress(packed: Union[bytes, bytearray, memoryview], endian: 'Endian') -> 'Point':
     """
     Decompresses a byte vector into a point on the BabyJubjub curve.
     
@@ -110,3 +156,38 @@ def decompress(packed: Union[bytes, bytearray], endian: 'Endian') -> 'Point':
     """
     ...
 
+@overload
+def decompress_batch(packed: np.ndarray, endian: 'Endian', threads: int = 1) -> tuple[np.ndarray, np.ndarray]:
+    """
+    Decompresses an (n, 32) uint8 array into points on the BabyJubjub curve, with the GIL released.
+    
+    :param packed: The (n, 32) uint8 array of compressed points.
+    :param endian: The endianness used in the rows, also used for the output coordinates.
+    :param threads: The number of threads to spread the rows across.
+    :return: The (n, 2, 32) uint8 array of (x, y) and the (n,) bool array of validity, invalid rows have zero coordinates.
+    """
+    ...
+
+@overload
+def decompress_batch(packed: Union[bytes, bytearray, memoryview, list[Union[bytes, bytearray, memoryview]]], endian: 'Endian', threads: int = 1) -> list[Optional['Point']]:
+    """
+    Decompresses 32-byte vectors into points on the BabyJubjub curve with a single field inversion per thread.
+    A single contiguous buffer (bytes, memoryview, ...) of n * 32 bytes is read in place without copying.
+    
+    :param packed: The 32-byte vectors to decompress, either as a list or as one contiguous buffer.
+    :param endian: The endianness used in the byte vectors.
+    :param threads: The number of threads to spread the work across.
+    :return: The decompressed points in the same order, None for invalid inputs.
+    """
+    ...
+
+def compress_batch(points: np.ndarray, endian: 'Endian', threads: int = 1) -> np.ndarray:
+    """
+    Compresses points on the BabyJubjub curve, with the GIL released.
+    
+    :param points: The (n, 2, 32) uint8 array of (x, y) in the given endianness.
+    :param endian: The endianness used for both the coordinates and the compressed rows.
+    :param threads: The number of threads to spread the rows across.
+    :return: The (n, 32) uint8 array of compressed points.
+    """
+    ...
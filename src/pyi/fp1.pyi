@@ -101,6 +101,15 @@ class Fp1:
         """
         ...
 
+    def batch_inv(self, a: list[int]) -> list[int]:
+        """
+        Compute the modular inverses of a list of integers with a single inversion.
+
+        :param a: The integers to find the modular inverses of.
+        :return: The modular inverses in the same order. Integers without a modular inverse map to 0.
+        """
+        ...
+
     def neg(self, a: int) -> int:
         """
         Negate an integer in the field.
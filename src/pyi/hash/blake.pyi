@@ -4,7 +4,7 @@ This module provides type annotations for the BLAKE hash functions.
 from typing import Union
 
 
-def blake256(bytes: Union[bytes, bytearray]) -> bytearray:
+def blake256(bytes: Union[bytes, bytearray, memoryview]) -> bytearray:
     """
     Compute BLAKE256 hash of a byte array.
 
@@ -12,3 +12,34 @@ def blake256(bytes: Union[bytes, bytearray]) -> bytearray:
     :return: The BLAKE256 hash of the byte array.
     """
     ...
+
+class Blake256:
+    """
+    Incremental BLAKE256 hasher, call update() any number of times then finalize() once.
+    Unlike blake256(), an empty input gives the digest of the empty message.
+    """
+
+    def __init__(self) -> None:
+        ...
+
+    def update(self, data: Union[bytes, bytearray, memoryview, str]) -> None:
+        """
+        Absorb more bytes, buffers are read in place and strings are hashed as their UTF-8 bytes.
+
+        :param data: The bytes to absorb.
+        """
+        ...
+
+    def finalize(self) -> bytearray:
+        """
+        Return the digest of everything absorbed so far and reset the hasher.
+
+        :return: The BLAKE256 hash.
+        """
+        ...
+
+    def reset(self) -> None:
+        """
+        Discard everything absorbed so far.
+        """
+        ...
@@ -3,8 +3,10 @@ This module provides type annotations for the Keccak hash functions.
 """
 from typing import Union
 
+import numpy as np
 
-def keccak256(bytes: Union[bytes, bytearray]) -> bytearray:
+
+def keccak256(bytes: Union[bytes, bytearray, memoryview]) -> bytearray:
     """
     Compute Keccak256 hash of a byte array.
 
@@ -12,3 +14,43 @@ def keccak256(bytes: Union[bytes, bytearray]) -> bytearray:
     :return: The Keccak256 hash of the byte array.
     """
     ...
+
+def keccak256_batch(data: np.ndarray, threads: int = 1) -> np.ndarray:
+    """
+    Compute Keccak256 hash of every row of a 2D uint8 array, with the GIL released.
+
+    :param data: The (n, m) uint8 array, one message of m bytes per row.
+    :param threads: The number of threads to spread the rows across.
+    :return: The (n, 32) uint8 array of digests.
+    """
+    ...
+
+class Keccak256:
+    """
+    Incremental Keccak256 hasher, call update() any number of times then finalize() once.
+    """
+
+    def __init__(self) -> None:
+        ...
+
+    def update(self, data: Union[bytes, bytearray, memoryview, str]) -> None:
+        """
+        Absorb more bytes, buffers are read in place and strings are hashed as their UTF-8 bytes.
+
+        :param data: The bytes to absorb.
+        """
+        ...
+
+    def finalize(self) -> bytearray:
+        """
+        Return the digest of everything absorbed so far and reset the hasher.
+
+        :return: The Keccak256 hash.
+        """
+        ...
+
+    def reset(self) -> None:
+        """
+        Discard everything absorbed so far.
+        """
+        ...
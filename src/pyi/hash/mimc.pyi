@@ -3,10 +3,12 @@ This module provides type annotations for the MiMC hash functions.
 """
 from typing import Union
 
+import numpy as np
 
-def mimc_sponge(preimages: list[Union[bytes, bytearray]],
+
+def mimc_sponge(preimages: list[Union[bytes, bytearray, memoryview]],
                 outputs: int,
-                key: Union[bytes, bytearray],
+                key: Union[bytes, bytearray, memoryview],
                 preimage_endian: 'Endian' = 'Endian'.BE,
                 key_endian: 'Endian' = 'Endian'.BE,
                 digest_endian: 'Endian' = 'Endian'.BE) -> list[bytearray]:
@@ -22,3 +24,24 @@ def mimc_sponge(preimages: list[Union[bytes, bytearray]],
     :return: The MiMC sponge hash of the preimages.
     """
     ...
+
+def mimc_sponge_batch(preimages: np.ndarray,
+                      outputs: int = 1,
+                      key: Union[bytes, bytearray, memoryview] = b'',
+                      preimage_endian: 'Endian' = 'Endian'.BE,
+                      key_endian: 'Endian' = 'Endian'.BE,
+                      digest_endian: 'Endian' = 'Endian'.BE,
+                      threads: int = 1) -> np.ndarray:
+    """
+    Compute MiMC sponge hash of every row of a uint8 array, with the GIL released.
+
+    :param preimages: The (n, 32) uint8 array of one preimage per sponge, or (n, k, 32) for k preimages per sponge.
+    :param outputs: The number of output hashes to generate per sponge.
+    :param key: The byte array key for the hash function, shared by every sponge.
+    :param preimage_endian: The endian format of the preimages (default is BE).
+    :param key_endian: The endian format of the key (default is BE).
+    :param digest_endian: The endian format of the output digest (default is BE).
+    :param threads: The number of threads to spread the rows across.
+    :return: The (n, outputs, 32) uint8 array of digests.
+    """
+    ...
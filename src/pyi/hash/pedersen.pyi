@@ -4,7 +4,7 @@ This module provides type annotations for the Pedersen hash function.
 from typing import Union
 
 
-def pedersen(preimage: Union[bytes, bytearray]) -> bytearray:
+def pedersen(preimage: Union[bytes, bytearray, memoryview]) -> bytearray:
     """
     Compute the Pedersen hash of the given preimage.
 
@@ -0,0 +1,196 @@
+#include <iden3math/bigint.h>
+#include <iden3math/prime.h>
+#include <gtest/gtest.h>
+#include "helper.h"
+
+namespace iden3math {
+
+TEST(bigint, native_constructors) {
+    EXPECT_EQ("0", BigInt(uint64_t(0)).str(10));
+    EXPECT_EQ("18446744073709551615", BigInt(UINT64_MAX).str(10));
+    EXPECT_EQ("-9223372036854775808", BigInt(INT64_MIN).str(10));
+    EXPECT_EQ("9223372036854775807", BigInt(INT64_MAX).str(10));
+    EXPECT_EQ("-2147483648", BigInt(INT32_MIN).str(10));
+    EXPECT_EQ("4294967295", BigInt(UINT32_MAX).str(10));
+    size_t n = 123;
+    EXPECT_EQ(BigInt(n) * 2, 246);
+    EXPECT_EQ(BigInt(UINT64_MAX) + 1, BigInt(2).pow(64));
+}
+
+TEST(bigint, inline_and_heap_storage) {
+    const auto max_inline = BigInt(2).pow(256) - 1;
+    const auto min_heap = BigInt(2).pow(256);
+    EXPECT_EQ(256, max_inline.bits_size());
+    EXPECT_EQ(257, min_heap.bits_size());
+    // Cross the boundary in both directions, in place and through temporaries
+    auto a = max_inline;
+    ++a;
+    EXPECT_EQ(min_heap, a);
+    a -= 1;
+    EXPECT_EQ(max_inline, a);
+    a = a * a;
+    EXPECT_EQ(512, a.bits_size());
+    a %= prime::bn254();
+    EXPECT_LT(a, prime::bn254());
+    EXPECT_EQ(-max_inline - 1, -min_heap);
+    // Copy and move in every combination of storage
+    for (const auto& v : {BigInt(0), BigInt(-5), max_inline, -min_heap, min_heap * min_heap}) {
+        SCOPED_TRACE_BIGINT(v, 16)
+        BigInt copy(v);
+        EXPECT_EQ(v, copy);
+        BigInt moved(std::move(copy));
+        EXPECT_EQ(v, moved);
+        EXPECT_EQ(0, copy);
+        BigInt small = 7;
+        small = moved;
+        EXPECT_EQ(v, small);
+        BigInt big = min_heap;
+        big = moved;
+        EXPECT_EQ(v, big);
+        big = std::move(small);
+        EXPECT_EQ(v, big);
+    }
+}
+
+TEST(bigint, bytes_and_string) {
+    for (size_t size : {0, 1, 31, 32, 33, 64}) {
+        ByteVec1D bytes(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<Byte>(i + 1);
+        }
+        const BigInt be(bytes, BE);
+        const BigInt le(bytes, LE);
+        EXPECT_EQ(bytes, be.bytes(BE));
+        EXPECT_EQ(bytes, le.bytes(LE));
+        EXPECT_EQ(be, BigInt(be.str(16), 16));
+        EXPECT_EQ(le, BigInt(le.str(10), 10));
+    }
+    EXPECT_EQ(BigInt(ByteVec1D{0x00, 0x00, 0x01}, BE), 1);
+    EXPECT_EQ(BigInt(ByteVec1D{0x01, 0x00, 0x00}, BE), 0x10000);
+    EXPECT_EQ("-ff", BigInt(-255).str(16));
+    EXPECT_THROW(BigInt("xyz", 10), std::invalid_argument);
+}
+
+TEST(bigint, fixed_width_bytes) {
+    const auto p = prime::bn254();
+    for (auto endian : {BE, LE}) {
+        for (const auto& v : {BigInt(0), BigInt(0x1234), p - 1, BigInt(2).pow(256) - 1}) {
+            SCOPED_TRACE_BIGINT(v, 16)
+            std::array<uint8_t, 32> out;
+            out.fill(0xaa);
+            v.to_bytes_fixed(out, endian);
+            auto expected = v.bytes(endian);
+            expected.insert(BE == endian ? expected.begin() : expected.end(), 32 - expected.size(), 0x00);
+            EXPECT_TRUE(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+            EXPECT_EQ(v, BigInt::from_bytes(out, endian));
+            EXPECT_EQ(v, BigInt::from_bytes(std::span(out).subspan(BE == endian ? 32 - v.bytes_size() : 0, v.bytes_size()), endian));
+        }
+        std::array<uint8_t, 40> wide;
+        wide.fill(0xff);
+        EXPECT_EQ(BigInt(2).pow(320) - 1, BigInt::from_bytes(wide, endian));
+        std::array<uint8_t, 31> narrow;
+        EXPECT_THROW(p.to_bytes_fixed(narrow, endian), std::out_of_range);
+        EXPECT_NO_THROW(BigInt(2).pow(248).to_bytes_fixed(std::span(wide).first(32), endian));
+        EXPECT_EQ(BigInt(2).pow(248), BigInt::from_bytes(std::span(wide).first(32), endian));
+    }
+}
+
+TEST(bigint, signed_semantics) {
+    EXPECT_EQ(-3, BigInt(-7) / 2);
+    EXPECT_EQ(-1, BigInt(-7) % 2);
+    EXPECT_EQ(-4, BigInt(-7) >> 1);
+    EXPECT_EQ(-14, BigInt(-7) << 1);
+    EXPECT_EQ(BigInt(1) << 64, BigInt(1) << uint64_t(64));
+    EXPECT_THROW((void)(BigInt(1) << -1), std::invalid_argument);
+    EXPECT_THROW((void)(BigInt(1) >> (int64_t(1) << 40)), std::invalid_argument);
+    EXPECT_EQ(-6, ~BigInt(5));
+    EXPECT_EQ(255, BigInt(-1) & 255);
+    EXPECT_EQ(-1, BigInt(-2) | 1);
+    EXPECT_EQ(3, BigInt(5) ^ 6);
+    EXPECT_TRUE(BigInt(-3).odd());
+    EXPECT_TRUE(!BigInt(0));
+    EXPECT_EQ(BigInt(3).mod_inv(7), 5);
+    EXPECT_EQ(BigInt(7).mod_inv(14), std::nullopt);
+    EXPECT_EQ(BigInt(3).pow_mod(BigInt(-1), BigInt(7)), 5);
+    BigInt n(5);
+    EXPECT_EQ(5, n++);
+    EXPECT_EQ(6, n--);
+    EXPECT_EQ(5, n);
+}
+
+TEST(bigint, destination_passing) {
+    const auto p = prime::bn254();
+    const auto big = BigInt(2).pow(300) + 5;
+    BigInt out;
+    BigInt::add(out, p, 1);
+    EXPECT_EQ(p + 1, out);
+    BigInt::sub(out, 1, p);
+    EXPECT_EQ(1 - p, out);
+    BigInt::mul(out, big, big);
+    EXPECT_EQ(big * big, out);
+    BigInt::mod(out, -big, p);
+    EXPECT_EQ(-big % p, out);
+    BigInt::powm(out, big, p - 2, p);
+    EXPECT_EQ(big.pow_mod(p - 2, p), out);
+    // Output aliasing an operand, across inline and heap storage
+    auto a = p;
+    BigInt::mul(a, a, a);
+    EXPECT_EQ(p * p, a);
+    BigInt::mod(a, a, p);
+    EXPECT_EQ(0, a);
+    a = 3;
+    BigInt::powm(a, a, p - 1, p);
+    EXPECT_EQ(1, a);
+    a = big;
+    BigInt::sub(a, a, big - 1);
+    EXPECT_EQ(1, a);
+    auto m = p;
+    BigInt::powm(m, 2, 10, m);
+    EXPECT_EQ(1024, m);
+}
+
+TEST(bigint, performance_copy) {
+    const auto a = prime::bn254() - 1;
+    BigInt b;
+    PERFORMANCE_TEST(TEN_MILLION, {
+        b = a;
+    })
+    EXPECT_EQ(a, b);
+}
+
+TEST(bigint, performance_bytes_fixed) {
+    const auto a = prime::bn254() - 1;
+    std::array<uint8_t, 32> out;
+    PERFORMANCE_TEST(TEN_MILLION, {
+        a.to_bytes_fixed(out, BE);
+    })
+    EXPECT_EQ(a, BigInt::from_bytes(out, BE));
+}
+
+TEST(bigint, performance_add) {
+    const auto a = prime::bn254() - 1;
+    const auto b = prime::bn254() - 2;
+    BigInt c;
+    PERFORMANCE_TEST(TEN_MILLION, {
+        c = a + b;
+    })
+}
+
+TEST(bigint, performance_mul_mod) {
+    const auto a = prime::bn254() - 1;
+    auto b = a;
+    PERFORMANCE_TEST(ONE_MILLION, {
+        b = a * b % prime::bn254();
+    })
+}
+
+TEST(bigint, performance_mul_mod_into) {
+    const auto a = prime::bn254() - 1;
+    auto b = a;
+    PERFORMANCE_TEST(ONE_MILLION, {
+        BigInt::mul(b, a, b);
+        BigInt::mod(b, b, prime::bn254());
+    })
+}
+
+} // namespace iden3math
@@ -129,6 +129,102 @@ TEST(babyjub, mul_scalar_1) {
     EXPECT_EQ(sum, mul);
 }
 
+TEST(babyjub, mul_scalar_wnaf) {
+    // Small scalars against repeated add(), every width
+    Point sum(0, 1);
+    for (uint32_t k = 0; k < 300; ++k) {
+        SCOPED_TRACE(k);
+        for (uint32_t w = 2; w <= 8; ++w) {
+            EXPECT_EQ(sum, mul_scalar_wnaf(generator(), k, w));
+        }
+        sum = add(sum, generator());
+    }
+    // Large and negative scalars, all widths agree
+    for (uint32_t i = 0; i < 50; ++i) {
+        SCOPED_TRACE(i);
+        auto k = SCALAR * (i + 1) + i;
+        auto expected = mul_scalar_wnaf(generator(), k, 2);
+        auto negated = Point(finite_field().neg(expected.x), expected.y);
+        for (uint32_t w = 3; w <= 8; ++w) {
+            EXPECT_EQ(expected, mul_scalar_wnaf(generator(), k, w));
+            EXPECT_EQ(negated, mul_scalar_wnaf(generator(), -k, w));
+        }
+    }
+    EXPECT_THROW(mul_scalar_wnaf(generator(), SCALAR, 1), std::invalid_argument);
+    EXPECT_THROW(mul_scalar_wnaf(generator(), SCALAR, 9), std::invalid_argument);
+}
+
+TEST(babyjub, mul_scalar_ct) {
+    Point sum(0, 1);
+    for (uint32_t k = 0; k < 100; ++k) {
+        SCOPED_TRACE(k);
+        EXPECT_EQ(sum, mul_scalar_ct(generator(), k));
+        sum = add(sum, generator());
+    }
+    for (uint32_t i = 0; i < 50; ++i) {
+        SCOPED_TRACE(i);
+        auto k = SCALAR * (i + 1) + i;
+        EXPECT_EQ(mul_scalar(generator(), k), mul_scalar_ct(generator(), k));
+        EXPECT_EQ(mul_scalar(generator(), -k), mul_scalar_ct(generator(), -k));
+        EXPECT_EQ(mul_scalar(generator(), k), mul_scalar_ct(generator(), k + group_order()));
+    }
+    EXPECT_EQ(Point(0, 1), mul_scalar_ct(generator(), group_order()));
+}
+
+TEST(babyjub, mul_base) {
+    std::vector<BigInt> scalars = {0, 1, 2, 15, 16, 17, 255, 256, -1, -SCALAR, group_order(), group_order() - 1, group_order() + 1, sub_group_order()};
+    for (uint32_t i = 0; i < 100; ++i) {
+        scalars.emplace_back(SCALAR * (i + 1) + i);
+    }
+    for (const auto& k : scalars) {
+        SCOPED_TRACE_BIGINT(k, 10)
+        EXPECT_EQ(mul_scalar(generator(), k), mul_base(k));
+    }
+    // Concurrent first use shares the same table
+    std::vector<std::shared_ptr<std::thread>> threads;
+    for (uint32_t i = 0; i < 4; ++i) {
+        threads.emplace_back(std::make_shared<std::thread>([i] {
+            EXPECT_EQ(mul_scalar(generator(), SCALAR + i), mul_base(SCALAR + i));
+        }));
+    }
+    for (auto& t : threads) {
+        t->join();
+    }
+}
+
+static void msm_inputs(size_t n, std::vector<Point>& points, std::vector<BigInt>& scalars) {
+    std::vector<PointExt> ext;
+    auto p = to_ext(generator());
+    for (uint32_t i = 0; i < n; ++i) {
+        p = add(p, to_ext(generator()));
+        ext.emplace_back(p);
+        scalars.emplace_back(SCALAR * (i + 1) + i);
+    }
+    points = normalize_batch(ext);
+}
+
+TEST(babyjub, msm) {
+    for (size_t n : {0, 1, 2, 5, 31, 32, 100}) {
+        SCOPED_TRACE(n);
+        std::vector<Point> points;
+        std::vector<BigInt> scalars;
+        msm_inputs(n, points, scalars);
+        if (n > 2) {
+            scalars[1] = -scalars[1];
+            scalars[2] = 0;
+        }
+        Point expected(0, 1);
+        for (size_t i = 0; i < n; ++i) {
+            expected = add(expected, mul_scalar(points[i], scalars[i]));
+        }
+        EXPECT_EQ(expected, msm(points, scalars));
+        EXPECT_EQ(expected, msm(points, scalars, 4));
+    }
+    std::vector<Point> points = {generator()};
+    std::vector<BigInt> scalars = {1, 2};
+    EXPECT_THROW(msm(points, scalars), std::invalid_argument);
+}
+
 TEST(babyjub, in_curve) {
     // Invalid
     std::vector invalid_points = {
@@ -246,6 +342,144 @@ TEST(babyjub, add) {
     }
 }
 
+TEST(babyjub, extended_coordinates) {
+    // Projective results should equal to the affine ones once normalized
+    auto k = SCALAR;
+    for (uint32_t i = 0; i < 100; ++i) {
+        auto a = mul_scalar(generator(), ++k);
+        auto b = mul_scalar(generator(), ++k);
+        SCOPED_TRACE_POINT(b, 10)
+        SCOPED_TRACE_POINT(a, 10)
+        auto ea = to_ext(a);
+        auto eb = to_ext(b);
+        EXPECT_EQ(a, to_affine(ea));
+        EXPECT_EQ(add(a, b), to_affine(add(ea, eb)));
+        EXPECT_EQ(add(a, a), to_affine(dbl(ea)));
+        EXPECT_EQ(dbl(ea), add(ea, ea));
+        EXPECT_EQ(mul_scalar(a, k), to_affine(mul_scalar(ea, k)));
+        EXPECT_EQ(ea, add(ea, PointExt()));
+    }
+    EXPECT_EQ(Point(0, 1), to_affine(PointExt()));
+    EXPECT_EQ(Point(0, 1), to_affine(mul_scalar(to_ext(mul_scalar(generator(), 8)), sub_group_order())));
+}
+
+TEST(babyjub, normalize_compress_batch) {
+    std::vector<PointExt> points = {PointExt()};
+    auto k = SCALAR;
+    for (uint32_t i = 0; i < 100; ++i) {
+        points.emplace_back(mul_scalar(to_ext(generator()), ++k));
+    }
+    auto affine = normalize_batch(points);
+    auto packed_le = compress_batch(points, LE);
+    auto packed_be = compress_batch(points, BE);
+    ASSERT_EQ(points.size(), affine.size());
+    ASSERT_EQ(points.size(), packed_le.size());
+    ASSERT_EQ(points.size(), packed_be.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        SCOPED_TRACE(i);
+        auto expected = to_affine(points[i]);
+        EXPECT_EQ(expected, affine[i]);
+        EXPECT_EQ(compress(expected, LE), packed_le[i]);
+        EXPECT_EQ(compress(expected, BE), packed_be[i]);
+    }
+    EXPECT_TRUE(normalize_batch({}).empty());
+}
+
+TEST(babyjub, performance_mul_scalar) {
+    Point p;
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        p = mul_scalar(generator(), SCALAR);
+    })
+    EXPECT_TRUE(in_curve(p));
+}
+
+TEST(babyjub, performance_mul_scalar_wnaf) {
+    Point p;
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        p = mul_scalar_wnaf(generator(), SCALAR, 5);
+    })
+    EXPECT_TRUE(in_curve(p));
+}
+
+TEST(babyjub, performance_mul_scalar_ct) {
+    Point p;
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        p = mul_scalar_ct(generator(), SCALAR);
+    })
+    EXPECT_TRUE(in_curve(p));
+}
+
+TEST(babyjub, performance_mul_base) {
+    Point p = mul_base(0); // Exclude the table building
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        p = mul_base(SCALAR);
+    })
+    EXPECT_TRUE(in_curve(p));
+}
+
+TEST(babyjub, performance_compress_batch) {
+    std::vector<PointExt> points;
+    auto p = to_ext(generator());
+    for (uint32_t i = 0; i < ONE_THOUSAND; ++i) {
+        p = dbl(p);
+        points.emplace_back(p);
+    }
+    std::vector<ByteVec1D> packed;
+    PERFORMANCE_TEST(ONE_THOUSAND / 10, {
+        packed = compress_batch(points, LE);
+    })
+    EXPECT_EQ(ONE_THOUSAND, packed.size());
+}
+
+TEST(babyjub, performance_msm) {
+    std::vector<Point> points;
+    std::vector<BigInt> scalars;
+    msm_inputs(ONE_THOUSAND, points, scalars);
+    Point p;
+    PERFORMANCE_TEST(10, {
+        p = msm(points, scalars);
+    })
+    EXPECT_TRUE(in_curve(p));
+}
+
+// Pippenger against the naive loop, n = 16 ... 1M, run with --gtest_also_run_disabled_tests
+TEST(babyjub, DISABLED_benchmark_msm) {
+    std::vector<Point> points;
+    std::vector<BigInt> scalars;
+    msm_inputs(ONE_MILLION, points, scalars);
+    const auto threads = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+    for (size_t n = 16; n <= ONE_MILLION; n = n * 4 > ONE_MILLION && n < ONE_MILLION ? ONE_MILLION : n * 4) {
+        std::span<const Point> p(points.data(), n);
+        std::span<const BigInt> k(scalars.data(), n);
+        Point naive(0, 1);
+        Point pippenger;
+        Point parallel;
+        GTEST_LOG("n = " << n << ", naive");
+        {
+            PERFORMANCE_TEST(1, {
+                naive = Point(0, 1);
+                for (size_t i = 0; i < n; ++i) {
+                    naive = add(naive, mul_scalar(p[i], k[i]));
+                }
+            })
+        }
+        GTEST_LOG("n = " << n << ", msm");
+        {
+            PERFORMANCE_TEST(1, {
+                pippenger = msm(p, k);
+            })
+        }
+        GTEST_LOG("n = " << n << ", msm with " << threads << " threads");
+        {
+            PERFORMANCE_TEST(1, {
+                parallel = msm(p, k, threads);
+            })
+        }
+        EXPECT_EQ(naive, pippenger);
+        EXPECT_EQ(naive, parallel);
+    }
+}
+
 TEST(babyjub, compress_decompress_le) {
     for (uint32_t i = 0; i < 1000; ++i) {
         SCOPED_TRACE(i);
@@ -272,4 +506,55 @@ TEST(babyjub, compress_decompress_be) {
     }
 }
 
+TEST(babyjub, decompress_batch) {
+    for (auto endian : {LE, BE}) {
+        SCOPED_TRACE(endian);
+        std::vector<std::array<uint8_t, 32>> packed;
+        auto k = SCALAR;
+        for (uint32_t i = 0; i < 200; ++i) {
+            auto bytes = compress(mul_scalar(generator(), ++k), endian);
+            std::array<uint8_t, 32> a{};
+            std::copy(bytes.begin(), bytes.end(), a.begin());
+            packed.emplace_back(a);
+        }
+        // Invalid inputs, y >= p and y without a matching x
+        std::array<uint8_t, 32> invalid{};
+        invalid.fill(0x7f);
+        packed.emplace_back(invalid);
+        auto p = prime().bytes(endian);
+        std::copy(p.begin(), p.end(), invalid.begin());
+        packed.emplace_back(invalid);
+        invalid.fill(0);
+        invalid[LE == endian ? 0 : 31] = 2;
+        packed.emplace_back(invalid);
+        for (uint32_t threads : {1, 3}) {
+            SCOPED_TRACE(threads);
+            auto unpacked = decompress_batch(packed, endian, threads);
+            ASSERT_EQ(packed.size(), unpacked.size());
+            for (size_t i = 0; i < packed.size(); ++i) {
+                SCOPED_TRACE(i);
+                EXPECT_EQ(decompress(ByteVec1D(packed[i].begin(), packed[i].end()), endian), unpacked[i]);
+            }
+        }
+    }
+    EXPECT_TRUE(decompress_batch({}, LE).empty());
+}
+
+TEST(babyjub, performance_decompress_batch) {
+    std::vector<std::array<uint8_t, 32>> packed;
+    auto p = to_ext(generator());
+    for (uint32_t i = 0; i < ONE_THOUSAND; ++i) {
+        p = dbl(p);
+        auto bytes = compress(to_affine(p), LE);
+        std::array<uint8_t, 32> a{};
+        std::copy(bytes.begin(), bytes.end(), a.begin());
+        packed.emplace_back(a);
+    }
+    std::vector<std::optional<Point>> unpacked;
+    PERFORMANCE_TEST(10, {
+        unpacked = decompress_batch(packed, LE);
+    })
+    EXPECT_EQ(ONE_THOUSAND, unpacked.size());
+}
+
 } // namespace iden3math::ec::babyjub
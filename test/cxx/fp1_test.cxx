@@ -1,5 +1,6 @@
 #include <iden3math/ec/babyjub.h>
 #include <iden3math/fp1.h>
+#include <iden3math/fp254.h>
 #include <gtest/gtest.h>
 #include "helper.h"
 
@@ -31,6 +32,41 @@ void init() {
     EXPECT_EQ(3, PRIMES.size());
 }
 
+TEST(fp1, context) {
+    init();
+    for (const auto& prime : PRIMES) {
+        SCOPED_TRACE("Prime = " + prime.str(10));
+        Fp1 F(prime);
+        Fp1 G(prime);
+        const auto& ctx = F.context();
+        EXPECT_EQ(&ctx, &G.context());
+        EXPECT_EQ(&ctx, Fp1::context_of(prime).get());
+        EXPECT_EQ(prime, ctx.p);
+        // Tonelli–Shanks
+        EXPECT_TRUE(ctx.q.odd());
+        EXPECT_EQ(prime - 1, ctx.q * BigInt(2).pow(ctx.s));
+        EXPECT_FALSE(F.has_sqrt(ctx.non_residue));
+        for (uint32_t i = 2; i < ctx.non_residue; ++i) {
+            EXPECT_TRUE(F.has_sqrt(i));
+        }
+        EXPECT_EQ(ctx.non_residue.pow_mod(ctx.q, prime), ctx.z);
+        // Montgomery
+        EXPECT_EQ((BigInt(1) << static_cast<uint32_t>(64 * ctx.limbs)) % prime, ctx.r);
+        EXPECT_EQ(ctx.r * ctx.r % prime, ctx.r2);
+        auto bytes = prime.bytes(LE);
+        uint64_t p0 = 0;
+        for (size_t i = 0; i < bytes.size() && i < 8; ++i) {
+            p0 |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+        }
+        EXPECT_EQ(UINT64_MAX, ctx.n_prime * p0);
+    }
+    const auto& bn254 = Fp1(PRIME_BN254).context();
+    EXPECT_EQ(5, bn254.non_residue);
+    EXPECT_EQ(0xc2e1f593efffffff, bn254.n_prime);
+    EXPECT_TRUE(Fp254::from_mont(Fp254(bn254.r).limbs()).is_one()); // Same R as Fp254
+    EXPECT_EQ(bn254.r, Fp254::from_mont(Fp254(bn254.r2).limbs()).big_int());
+}
+
 TEST(fp1, mod_reduce) {
     init();
     for (const auto& prime : PRIMES) {
@@ -107,6 +143,31 @@ TEST(fp1, mul) {
     }
 }
 
+TEST(fp1, into) {
+    init();
+    for (const auto& prime : PRIMES) {
+        SCOPED_TRACE("Prime = " + prime.str(10));
+        Fp1 F(prime);
+        for (const auto& a : {BigInt(0), BigInt(-2), prime - 1, prime + 2, prime * prime + 3, -prime * prime - 3}) {
+            for (const auto& b : {BigInt(0), BigInt(5), -prime + 1, prime * 7 - 1}) {
+                BigInt out = 123;
+                F.add_into(out, a, b);
+                EXPECT_EQ(F.add(a, b), out);
+                F.sub_into(out, a, b);
+                EXPECT_EQ(F.sub(a, b), out);
+                F.mul_into(out, a, b);
+                EXPECT_EQ(F.mul(a, b), out);
+                out = a;
+                F.mul_into(out, out, b);
+                EXPECT_EQ(F.mul(a, b), out);
+                out = b;
+                F.sub_into(out, a, out);
+                EXPECT_EQ(F.sub(a, b), out);
+            }
+        }
+    }
+}
+
 TEST(fp1, div) {
     init();
     for (const auto& prime : PRIMES) {
@@ -251,6 +312,24 @@ TEST(fp1, mod_inv) {
     }
 }
 
+TEST(fp1, batch_inv) {
+    init();
+    for (const auto& prime : PRIMES) {
+        SCOPED_TRACE("Prime = " + prime.str(10));
+        Fp1 F(prime);
+        std::vector<BigInt> values = {1, -1, 2, -2, 0, prime - 1, prime, prime + 1, 3, 16};
+        auto inverted = values;
+        F.batch_inv(inverted);
+        for (size_t i = 0; i < values.size(); ++i) {
+            SCOPED_TRACE_BIGINT(values[i], 10)
+            EXPECT_EQ(F.mod_inv(values[i]).value_or(0), inverted[i]);
+        }
+        std::vector<BigInt> empty;
+        F.batch_inv(empty);
+        EXPECT_TRUE(empty.empty());
+    }
+}
+
 TEST(fp1, neg) {
     init();
     for (const auto& prime : PRIMES) {
@@ -280,6 +359,13 @@ TEST(fp1, has_sqrt) {
     }
 }
 
+TEST(fp1, peformance_construct) {
+    init();
+    PERFORMANCE_TEST(ONE_MILLION, {
+        Fp1 F(PRIME_BN254);
+    })
+}
+
 TEST(fp1, peformance_mod_reduce) {
     Fp1 F(ec::babyjub::prime());
     auto a = F.mul(ec::babyjub::prime(), 2);
@@ -315,6 +401,16 @@ TEST(fp1, peformance_mul) {
     })
 }
 
+TEST(fp1, peformance_mul_into) {
+    Fp1 F(ec::babyjub::prime());
+    auto a = *F.div(ec::babyjub::prime(), 2);
+    auto b = *F.div(ec::babyjub::prime(), 3);
+    BigInt x;
+    PERFORMANCE_TEST(ONE_MILLION, {
+        F.mul_into(x, a, b);
+    })
+}
+
 TEST(fp1, peformance_div) {
     Fp1 F(ec::babyjub::prime());
     std::optional<BigInt> x;
@@ -373,6 +469,18 @@ TEST(fp1, peformance_has_sqrt) {
     })
 }
 
+TEST(fp1, peformance_batch_inv) {
+    init();
+    Fp1 F(PRIME_BN254);
+    std::vector<BigInt> values;
+    for (uint32_t i = 0; i < ONE_THOUSAND; ++i) {
+        values.emplace_back(PRIME_BN254 - 1 - i);
+    }
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        F.batch_inv(values);
+    })
+}
+
 TEST(fp1, peformance_neg) {
     Fp1 F(ec::babyjub::prime());
     auto a = *F.div(ec::babyjub::prime(), 2);
@@ -0,0 +1,145 @@
+#include <iden3math/fp1.h>
+#include <iden3math/fp254.h>
+#include <iden3math/prime.h>
+#include <gtest/gtest.h>
+#include "helper.h"
+
+namespace iden3math {
+
+static std::vector<BigInt> samples() {
+    const auto& p = prime::bn254();
+    std::vector<BigInt> values = {0, 1, 2, 3, 5, 16, -1, -2, p - 1, p - 2, p, p + 1, p * 2 + 3, (p - 1) / 2, (p + 1) / 2};
+    for (uint32_t i = 0; i < 100; ++i) {
+        values.emplace_back(BigInt(3).pow_mod(BigInt(1000 + i), p));
+    }
+    return values;
+}
+
+TEST(fp254, convert) {
+    Fp1 F(prime::bn254());
+    for (const auto& a : samples()) {
+        SCOPED_TRACE_BIGINT(a, 10)
+        EXPECT_EQ(F.mod_reduce(a), Fp254(a).big_int());
+        EXPECT_EQ(Fp254(a), Fp254::from_limbs(Fp254(a).limbs()));
+    }
+    EXPECT_EQ(Fp254(0), Fp254::zero());
+    EXPECT_EQ(Fp254(1), Fp254::one());
+    EXPECT_EQ(Fp254(uint64_t(168700)).big_int(), 168700);
+    EXPECT_TRUE(Fp254(prime::bn254()).is_zero());
+    EXPECT_TRUE(Fp254(prime::bn254() + 1).is_one());
+    // Unreduced limbs up to 2²⁵⁶ - 1
+    const auto max = BigInt(2).pow(256) - 1;
+    EXPECT_EQ(Fp254(max), Fp254::from_limbs({UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX}));
+    EXPECT_TRUE(Fp254::from_limbs(Fp254::modulus()).is_zero());
+}
+
+TEST(fp254, add_sub_mul) {
+    Fp1 F(prime::bn254());
+    auto values = samples();
+    for (size_t i = 0; i < values.size(); ++i) {
+        const auto& a = values[i];
+        const auto& b = values[values.size() - 1 - i];
+        SCOPED_TRACE_BIGINT(a, 10)
+        SCOPED_TRACE_BIGINT(b, 10)
+        EXPECT_EQ(F.add(a, b), (Fp254(a) + Fp254(b)).big_int());
+        EXPECT_EQ(F.sub(a, b), (Fp254(a) - Fp254(b)).big_int());
+        EXPECT_EQ(F.mul(a, b), (Fp254(a) * Fp254(b)).big_int());
+        EXPECT_EQ(F.square(a), Fp254(a).square().big_int());
+        EXPECT_EQ(F.add(a, a), Fp254(a).dbl().big_int());
+        EXPECT_EQ(F.neg(a), (-Fp254(a)).big_int());
+    }
+}
+
+TEST(fp254, pow_inv) {
+    Fp1 F(prime::bn254());
+    for (const auto& a : samples()) {
+        SCOPED_TRACE_BIGINT(a, 10)
+        EXPECT_EQ(*F.pow(a, 5), Fp254(a).pow(BigInt(5)).big_int());
+        EXPECT_EQ(*F.pow(a, prime::bn254() - 3), Fp254(a).pow(prime::bn254() - 3).big_int());
+        auto inv = F.mod_inv(a);
+        if (std::nullopt == inv) {
+            EXPECT_TRUE(Fp254(a).inv().is_zero());
+        } else {
+            EXPECT_EQ(*inv, Fp254(a).inv().big_int());
+        }
+    }
+}
+
+TEST(fp254, batch_inv) {
+    auto values = samples();
+    std::vector<Fp254> inverted;
+    for (const auto& a : values) {
+        inverted.emplace_back(a);
+    }
+    Fp254::batch_inv(inverted);
+    for (size_t i = 0; i < values.size(); ++i) {
+        SCOPED_TRACE_BIGINT(values[i], 10)
+        EXPECT_EQ(Fp254(values[i]).inv(), inverted[i]);
+    }
+}
+
+TEST(fp254, sqrt) {
+    Fp1 F(prime::bn254());
+    for (const auto& a : samples()) {
+        SCOPED_TRACE_BIGINT(a, 10)
+        auto x = Fp254(a).sqrt();
+        EXPECT_EQ(F.mod_reduce(a) == 0 || F.has_sqrt(a), std::nullopt != x);
+        if (std::nullopt != x) {
+            EXPECT_EQ(Fp254(a), x->square());
+        }
+    }
+}
+
+TEST(fp254, sqrt_residues) {
+    const auto non_residue = Fp254(5);
+    for (const auto& a : samples()) {
+        SCOPED_TRACE_BIGINT(a, 10)
+        auto a2 = Fp254(a).square();
+        auto x = a2.sqrt();
+        ASSERT_NE(std::nullopt, x);
+        EXPECT_EQ(a2, x->square());
+        EXPECT_TRUE(*x == Fp254(a) || *x == -Fp254(a));
+        EXPECT_EQ(a2.is_zero(), std::nullopt != (a2 * non_residue).sqrt());
+    }
+}
+
+TEST(fp254, peformance_add) {
+    auto a = Fp254(prime::bn254() - 2);
+    auto b = Fp254(prime::bn254() - 3);
+    PERFORMANCE_TEST(TEN_MILLION, {
+        a = a + b;
+    })
+}
+
+TEST(fp254, peformance_mul) {
+    auto a = Fp254(prime::bn254() - 2);
+    auto b = Fp254(prime::bn254() - 3);
+    PERFORMANCE_TEST(TEN_MILLION, {
+        a = a * b;
+    })
+}
+
+TEST(fp254, peformance_square) {
+    auto a = Fp254(prime::bn254() - 2);
+    PERFORMANCE_TEST(TEN_MILLION, {
+        a = a.square();
+    })
+}
+
+TEST(fp254, peformance_inv) {
+    auto a = Fp254(prime::bn254() - 1);
+    PERFORMANCE_TEST(ONE_MILLION, {
+        a = a.inv();
+    })
+}
+
+TEST(fp254, peformance_sqrt) {
+    std::optional<Fp254> x;
+    auto a = Fp254(prime::bn254() - 1);
+    PERFORMANCE_TEST(ONE_THOUSAND * 100, {
+        x = a.sqrt();
+    })
+    EXPECT_NE(std::nullopt, x);
+}
+
+} // namespace iden3math
@@ -185,6 +185,43 @@ TEST(blake256, digest_not_cleared_and_call_hash_func_again) {
     EXPECT_EQ(expected, serialize::bytes_to_hexstr(digest));
 }
 
+TEST(blake256, streaming_matches_one_shot) {
+    ByteVec1D input(Blake256::BLOCK * 4 + 9);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<Byte>(i * 31 + 7);
+    }
+    // 56 to 63 bytes of tail need a second padding block
+    for (size_t len : {size_t(1), size_t(55), size_t(56), size_t(63), Blake256::BLOCK, Blake256::BLOCK + 1, size_t(183), input.size()}) {
+        const ByteVec1D preimage(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(len));
+        ByteVec1D expected;
+        blake256(preimage, expected);
+        for (size_t chunk : {size_t(1), size_t(7), Blake256::BLOCK, Blake256::BLOCK + 3}) {
+            SCOPED_TRACE("len = " + std::to_string(len) + ", chunk = " + std::to_string(chunk));
+            Blake256 hasher;
+            for (size_t pos = 0; pos < len; pos += chunk) {
+                hasher.update(std::span(preimage).subspan(pos, std::min(chunk, len - pos)));
+            }
+            const auto digest = hasher.finalize();
+            EXPECT_EQ(expected, ByteVec1D(digest.begin(), digest.end()));
+        }
+    }
+    // Unlike blake256(), the hasher digests the empty message, and it is reset after finalize
+    Blake256 hasher;
+    hasher.update(input);
+    (void)hasher.finalize();
+    const auto digest = hasher.finalize();
+    EXPECT_EQ("716f6e863f744b9ac22c97ec7b76ea5f5908bc5b2f67c61510bfc4751384ea7a", serialize::bytes_to_hexstr(ByteVec1D(digest.begin(), digest.end())));
+}
+
+TEST(blake256, performance_streaming_1_mib_input) {
+    ByteVec1D input(1 << 20, 0xaa);
+    Blake256 hasher;
+    PERFORMANCE_TEST(100, {
+        hasher.update(input);
+        (void)hasher.finalize();
+    })
+}
+
 TEST(blake256, performance_call_64_bytes_input) {
     ByteVec1D input(64, 0xaa);
     ByteVec1D digest;
@@ -577,6 +577,75 @@ TEST(keccak256, preimage_len_5440_bytes) {
     EXPECT_EQ(expected, serialize::bytes_to_hexstr(digest));
 }
 
+TEST(keccak256, streaming_matches_one_shot) {
+    ByteVec1D input(Keccak256::RATE * 3 + 17);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<Byte>(i * 7 + 3);
+    }
+    for (size_t len : {size_t(0), size_t(1), Keccak256::RATE - 1, Keccak256::RATE, Keccak256::RATE + 1, input.size()}) {
+        const ByteVec1D preimage(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(len));
+        ByteVec1D expected;
+        keccak256(preimage, expected);
+        for (size_t chunk : {size_t(1), size_t(7), size_t(64), Keccak256::RATE, Keccak256::RATE + 5}) {
+            SCOPED_TRACE("len = " + std::to_string(len) + ", chunk = " + std::to_string(chunk));
+            Keccak256 hasher;
+            for (size_t pos = 0; pos < len; pos += chunk) {
+                hasher.update(std::span(preimage).subspan(pos, std::min(chunk, len - pos)));
+            }
+            const auto digest = hasher.finalize();
+            EXPECT_EQ(expected, ByteVec1D(digest.begin(), digest.end()));
+        }
+    }
+    // Reset after finalize, the hasher is reusable
+    Keccak256 hasher;
+    hasher.update(input);
+    (void)hasher.finalize();
+    const std::string text = "Transfer(address,address,uint256)";
+    hasher.update({reinterpret_cast<const uint8_t*>(text.data()), text.size()});
+    const auto digest = hasher.finalize();
+    EXPECT_EQ("ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef", serialize::bytes_to_hexstr(ByteVec1D(digest.begin(), digest.end())));
+}
+
+TEST(keccak256, many_matches_one_shot) {
+    constexpr size_t LONGEST = Keccak256::RATE * 3 + 17;
+    ByteVec1D input(LONGEST + 8);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<Byte>(i * 13 + 5);
+    }
+    // Mixed lengths so lanes finish at different segments, 19 messages leave leftovers for every group size
+    const size_t lens[] = {0, 1, 32, 64, Keccak256::RATE - 1, Keccak256::RATE, Keccak256::RATE + 1, 300, LONGEST, 7,
+                           Keccak256::RATE * 2, 55, 0, 200, 136, 1, 99, LONGEST - 1, 31};
+    std::vector<std::span<const uint8_t>> inputs;
+    std::vector<std::array<uint8_t, 32>> expected;
+    for (size_t i = 0; i < std::size(lens); ++i) {
+        inputs.emplace_back(input.data() + i % 5, lens[i]); // Unaligned starts too
+        Keccak256 hasher;
+        hasher.update(inputs.back());
+        expected.push_back(hasher.finalize());
+    }
+    for (uint32_t max_lanes : {1u, 4u, 8u}) {
+        SCOPED_TRACE("max_lanes = " + std::to_string(max_lanes));
+        std::vector<std::array<uint8_t, 32>> digests(inputs.size());
+        keccak256_many(inputs, digests, max_lanes);
+        EXPECT_EQ(expected, digests);
+    }
+    std::vector<std::array<uint8_t, 32>> digests(inputs.size() - 1);
+    EXPECT_THROW(keccak256_many(inputs, digests), std::invalid_argument);
+}
+
+TEST(keccak256, peformance_many_64_bytes_input) {
+    ByteVec1D input(64 * 1000, 0xaa);
+    std::vector<std::span<const uint8_t>> inputs;
+    for (size_t i = 0; i < 1000; ++i) {
+        inputs.emplace_back(input.data() + i * 64, 64);
+    }
+    std::vector<std::array<uint8_t, 32>> digests(inputs.size());
+    GTEST_LOG("Lanes: " << keccak256_many_lanes());
+    PERFORMANCE_TEST(1000, {
+        keccak256_many(inputs, digests);
+    })
+}
+
 TEST(keccak256, peformance_call_64_bytes_input) {
     ByteVec1D input(64, 0xaa);
     ByteVec1D digest;
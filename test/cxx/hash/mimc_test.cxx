@@ -166,6 +166,33 @@ TEST(mimc_sponge, preimage_val_0xff_2x32_bytes) {
     }
 }
 
+TEST(mimc_sponge, preimage_any_length_and_endian) {
+    const std::vector<std::string> expected = {
+        "2bcea035a1251603f1ceaf73cd4ae89427c47075bb8e3a944039ff1e3d6d2a6f",
+        "2f7d340a3c24b8ef9899ab5f019b85b87354c7f6c965a19ca090321f7e5425e9",
+        "0cf71423c39e70b9858eaa8e1dc3ac40a09c3927dc31d12014af16066f2bdcb6",
+    };
+    ByteVec1D key = {};
+    // Longer than 32 bytes, one of them carries p which reduces to 0
+    ByteVec1D p_plus_1 = (prime::bn254() + 1).bytes(BE);
+    serialize::pad(p_plus_1, 0x00, 8, true);
+    ByteVec2D preimages = {p_plus_1, ByteVec1D(40, 0x00)};
+    preimages[1].back() = 0x02;
+    ByteVec2D digests;
+    mimc_sponge(preimages, expected.size(), key, digests);
+    ASSERT_EQ(expected.size(), digests.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], serialize::bytes_to_hexstr(digests[i]));
+    }
+    // Little endian preimages, digests written over the preimages
+    digests = {{0x01, 0x00, 0x00}, {0x02}};
+    mimc_sponge(digests, expected.size(), key, digests, LE);
+    ASSERT_EQ(expected.size(), digests.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], serialize::bytes_to_hexstr(digests[i]));
+    }
+}
+
 TEST(mimc_sponge, digest_31_pad_to_32_bytes_under_big_little_endian) {
     // Check big endian digest padding
     std::vector<std::string> expected = {
@@ -248,4 +275,55 @@ TEST(mimc_sponge, peformance_2x32_bytes_in_32_bytes_out) {
     })
 }
 
+TEST(mimc_sponge, batch_matches_single) {
+    // 19 sponges, four full groups of 4 and a partial one
+    std::vector<std::array<uint8_t, 32>> pool(19 * 3);
+    for (size_t i = 0; i < pool.size(); ++i) {
+        for (size_t j = 0; j < 32; ++j) {
+            pool[i][j] = static_cast<uint8_t>(i * 37 + j * 11 + 1);
+        }
+    }
+    const ByteVec1D key = {0x09};
+    for (size_t count : {size_t(1), size_t(2), size_t(3)}) {
+        for (size_t outputs : {size_t(1), size_t(3)}) {
+            for (Endian endian : {BE, LE}) {
+                SCOPED_TRACE("count = " + std::to_string(count) + ", outputs = " + std::to_string(outputs) + ", endian = " + std::to_string(endian));
+                const std::span<const std::array<uint8_t, 32>> preimages(pool.data(), 19 * count);
+                std::vector<std::array<uint8_t, 32>> expected;
+                for (size_t i = 0; i < 19; ++i) {
+                    ByteVec2D group;
+                    for (size_t j = 0; j < count; ++j) {
+                        group.emplace_back(preimages[i * count + j].begin(), preimages[i * count + j].end());
+                    }
+                    ByteVec2D digests;
+                    mimc_sponge(group, outputs, key, digests, endian, BE, endian);
+                    for (const auto& digest : digests) {
+                        expected.emplace_back();
+                        std::copy(digest.begin(), digest.end(), expected.back().begin());
+                    }
+                }
+                for (uint32_t threads : {1u, 3u}) {
+                    std::vector<std::array<uint8_t, 32>> digests(19 * outputs);
+                    mimc_sponge_batch(preimages, count, outputs, key, digests, endian, BE, endian, threads);
+                    EXPECT_EQ(expected, digests);
+                }
+            }
+        }
+    }
+    std::vector<std::array<uint8_t, 32>> digests(10);
+    EXPECT_THROW(mimc_sponge_batch(std::span(pool).first(21), 2, 1, key, digests), std::invalid_argument);
+    EXPECT_THROW(mimc_sponge_batch(std::span(pool).first(20), 2, 2, key, digests), std::invalid_argument);
+}
+
+TEST(mimc_sponge, peformance_batch_2x32_bytes_in_32_bytes_out) {
+    std::vector<std::array<uint8_t, 32>> preimages(ONE_THOUSAND * 2);
+    for (auto& preimage : preimages) {
+        preimage.fill(0xaa);
+    }
+    std::vector<std::array<uint8_t, 32>> digests(ONE_THOUSAND);
+    PERFORMANCE_TEST(1, {
+        mimc_sponge_batch(preimages, 2, 1, {}, digests);
+    })
+}
+
 } // namespace iden3math::hash
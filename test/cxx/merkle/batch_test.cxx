@@ -0,0 +1,71 @@
+#include <iden3math/merkle/batch.h>
+#include <gtest/gtest.h>
+#include "../helper.h"
+
+namespace iden3math::merkle {
+
+static std::vector<Fp254> leaves(size_t n) {
+    std::vector<Fp254> out;
+    for (size_t i = 0; i < n; ++i) {
+        out.emplace_back(uint64_t(i * 1000003 + 7));
+    }
+    return out;
+}
+
+TEST(merkle_batch, generate_and_verify) {
+    const auto values = leaves(1000);
+    MerkleTree tree(11);
+    tree.insert(values);
+    // Duplicates and neighbours share most of their nodes
+    std::vector<uint64_t> indices;
+    for (uint64_t i = 0; i < 300; ++i) {
+        indices.push_back(i * 7919 % 1000);
+    }
+    indices.push_back(indices[0]);
+    std::vector<Fp254> claimed;
+    for (const auto index : indices) {
+        claimed.push_back(values[index]);
+    }
+    for (uint32_t threads : {1u, 4u}) {
+        SCOPED_TRACE("threads = " + std::to_string(threads));
+        auto paths = generate_paths_batch(tree, indices, threads);
+        ASSERT_EQ(indices.size(), paths.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            EXPECT_EQ(tree.path(indices[i]).siblings, paths[i].siblings);
+            EXPECT_EQ(indices[i], paths[i].index);
+        }
+        EXPECT_EQ(std::vector<bool>(indices.size(), true), verify_paths_batch(tree.root(), claimed, paths, threads));
+
+        // Tampered proofs fail on their own, the others still pass
+        auto leaves_bad = claimed;
+        leaves_bad[3] = Fp254::one();
+        paths[10].siblings[5] = Fp254::one();
+        paths[20].index ^= 1;
+        paths[30].siblings.pop_back();
+        auto expected = std::vector<bool>(indices.size(), true);
+        expected[3] = expected[10] = expected[20] = expected[30] = false;
+        EXPECT_EQ(expected, verify_paths_batch(tree.root(), leaves_bad, paths, threads));
+        EXPECT_EQ(std::vector<bool>(indices.size(), false), verify_paths_batch(Fp254::one(), claimed, paths, threads));
+    }
+    const std::vector<uint64_t> bad = {1, 1000};
+    EXPECT_THROW((void)generate_paths_batch(tree, bad), std::out_of_range);
+    EXPECT_THROW((void)verify_paths_batch(tree.root(), std::span(claimed).first(2), std::vector<Path>(3)), std::invalid_argument);
+}
+
+TEST(merkle_batch, performance_verify_1000_paths_depth_20) {
+    const auto values = leaves(1 << 12);
+    MerkleTree tree(20);
+    tree.insert(values, 4);
+    std::vector<uint64_t> indices;
+    std::vector<Fp254> claimed;
+    for (uint64_t i = 0; i < ONE_THOUSAND; ++i) {
+        indices.push_back(i * 4099 % values.size());
+        claimed.push_back(values[indices.back()]);
+    }
+    const auto paths = generate_paths_batch(tree, indices, 4);
+    PERFORMANCE_TEST(1, {
+        (void)verify_paths_batch(tree.root(), claimed, paths, 4);
+    })
+}
+
+} // namespace iden3math::merkle
@@ -0,0 +1,176 @@
+#include <iden3math/merkle/mapped_tree.h>
+#include <iden3math/merkle/tree.h>
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "../helper.h"
+
+namespace iden3math::merkle {
+
+class mapped_merkle_tree : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() / ("iden3math_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        std::filesystem::remove_all(dir_);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+    static std::vector<Fp254> leaves(size_t n, uint64_t seed = 7) {
+        std::vector<Fp254> out;
+        for (size_t i = 0; i < n; ++i) {
+            out.emplace_back(uint64_t(i * 1000003 + seed));
+        }
+        return out;
+    }
+    // Leaves the nodes file reflects, after magic and levels
+    void set_recorded(uint64_t recorded) const {
+        std::fstream file(dir_ / "nodes.bin", std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(16);
+        file.write(reinterpret_cast<const char*>(&recorded), sizeof(recorded));
+    }
+
+    std::filesystem::path dir_;
+    static constexpr uint64_t LOG_HEADER = 64;
+    static constexpr uint64_t RECORD = 40;
+};
+
+TEST_F(mapped_merkle_tree, matches_in_memory_tree) {
+    const auto values = leaves(300);
+    MerkleTree expected(10);
+    MappedMerkleTree tree(dir_.string(), 10);
+    EXPECT_EQ(expected.root(), tree.root());
+    for (size_t i = 0; i < 100; ++i) {
+        (void)expected.insert(values[i]);
+        EXPECT_EQ(i, tree.insert(values[i]));
+    }
+    expected.insert(std::span(values).subspan(100), 2);
+    tree.insert(std::span(values).subspan(100), 2);
+    EXPECT_EQ(expected.root(), tree.root());
+    EXPECT_EQ(300, tree.size());
+    for (uint64_t index : {uint64_t(0), uint64_t(99), uint64_t(100), uint64_t(299)}) {
+        EXPECT_EQ(expected.path(index).siblings, tree.path(index).siblings);
+        EXPECT_EQ(values[index], tree.leaf(index));
+    }
+    EXPECT_THROW((void)tree.path(300), std::out_of_range);
+}
+
+TEST_F(mapped_merkle_tree, reopen_serves_without_rebuild) {
+    const auto values = leaves(200);
+    Fp254 root;
+    {
+        MappedMerkleTree tree(dir_.string(), 12);
+        tree.insert(values);
+        root = tree.root();
+    }
+    EXPECT_THROW(MappedMerkleTree(dir_.string(), 11), std::runtime_error);
+    EXPECT_THROW(MappedMerkleTree(dir_.string(), 12, Fp254::one()), std::runtime_error);
+    MappedMerkleTree tree(dir_.string(), 12);
+    EXPECT_EQ(200, tree.size());
+    EXPECT_EQ(root, tree.root());
+    EXPECT_EQ(root, MerkleTree::compute_root(values[123], tree.path(123)));
+    // Appending after a reopen
+    MerkleTree expected(12);
+    expected.insert(values);
+    (void)expected.insert(Fp254::one());
+    (void)tree.insert(Fp254::one());
+    EXPECT_EQ(expected.root(), tree.root());
+}
+
+TEST_F(mapped_merkle_tree, recovers_from_crash_states) {
+    const auto values = leaves(50);
+    MerkleTree expected(8);
+    expected.insert(values);
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        tree.insert(values);
+    }
+    // Torn record at the end of the log is cut off
+    {
+        std::ofstream log(dir_ / "leaves.log", std::ios::app | std::ios::binary);
+        log.write("torn", 4);
+    }
+    // Nodes that had not recorded the last leaves replay them from the log
+    set_recorded(17);
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        EXPECT_EQ(50, tree.size());
+        EXPECT_EQ(expected.root(), tree.root());
+    }
+    EXPECT_EQ(LOG_HEADER + 50 * RECORD, std::filesystem::file_size(dir_ / "leaves.log"));
+    // The log lost its last leaf after the nodes took it in
+    std::filesystem::resize_file(dir_ / "leaves.log", LOG_HEADER + 49 * RECORD);
+    set_recorded(49);
+    MerkleTree shorter(8);
+    shorter.insert(std::span(values).first(49));
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        EXPECT_EQ(49, tree.size());
+        EXPECT_EQ(shorter.root(), tree.root());
+    }
+    // Lost nodes are rebuilt from the log
+    std::filesystem::remove(dir_ / "nodes.bin");
+    MappedMerkleTree tree(dir_.string(), 8);
+    EXPECT_EQ(shorter.root(), tree.root());
+    EXPECT_EQ(shorter.path(48).siblings, tree.path(48).siblings);
+}
+
+TEST_F(mapped_merkle_tree, unsynced_records_end_at_the_first_broken_one) {
+    const auto values = leaves(40);
+    MerkleTree expected(8);
+    expected.insert(std::span(values).first(30));
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        tree.insert(values);
+    }
+    // The filesystem kept the new size of the log but not the data of leaves 30 and 31
+    {
+        std::fstream log(dir_ / "leaves.log", std::ios::in | std::ios::out | std::ios::binary);
+        log.seekp(static_cast<std::streamoff>(LOG_HEADER + 30 * RECORD));
+        const std::vector<char> zeros(2 * RECORD, 0);
+        log.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    }
+    set_recorded(20);
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        EXPECT_EQ(30, tree.size());
+        EXPECT_EQ(expected.root(), tree.root());
+    }
+    EXPECT_EQ(LOG_HEADER + 30 * RECORD, std::filesystem::file_size(dir_ / "leaves.log"));
+    // A record moved to another slot does not pass either
+    {
+        std::fstream log(dir_ / "leaves.log", std::ios::in | std::ios::out | std::ios::binary);
+        std::vector<char> record(RECORD);
+        log.seekg(static_cast<std::streamoff>(LOG_HEADER + 28 * RECORD));
+        log.read(record.data(), static_cast<std::streamsize>(record.size()));
+        log.seekp(static_cast<std::streamoff>(LOG_HEADER + 29 * RECORD));
+        log.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+    set_recorded(29);
+    MappedMerkleTree tree(dir_.string(), 8);
+    EXPECT_EQ(29, tree.size());
+}
+
+TEST_F(mapped_merkle_tree, one_instance_per_directory) {
+    {
+        MappedMerkleTree tree(dir_.string(), 8);
+        (void)tree.insert(Fp254::one());
+        EXPECT_THROW(MappedMerkleTree(dir_.string(), 8), std::runtime_error);
+        EXPECT_EQ(1, tree.size());
+    }
+    MappedMerkleTree tree(dir_.string(), 8);
+    EXPECT_EQ(1, tree.size());
+}
+
+TEST_F(mapped_merkle_tree, performance_reopen_depth_20_with_2_pow_14_leaves) {
+    {
+        MappedMerkleTree tree(dir_.string(), 20);
+        tree.insert(leaves(1 << 14), 4);
+    }
+    PERFORMANCE_TEST(10, {
+        MappedMerkleTree tree(dir_.string(), 20);
+        (void)tree.path(_);
+    })
+}
+
+} // namespace iden3math::merkle
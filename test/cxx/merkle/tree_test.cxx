@@ -0,0 +1,132 @@
+#include <iden3math/hash/mimc.h>
+#include <iden3math/merkle/tree.h>
+#include <iden3math/serialize.h>
+#include <gtest/gtest.h>
+#include "../helper.h"
+
+namespace iden3math::merkle {
+
+// keccak256("tornado") mod p, the zero leaf of Tornado Cash
+static const Fp254 TORNADO_ZERO(BigInt("21663839004416932945382355908790599225266501822907911457504978515578255421292", 10));
+
+static std::vector<Fp254> leaves(size_t n) {
+    std::vector<Fp254> out;
+    for (size_t i = 0; i < n; ++i) {
+        out.emplace_back(uint64_t(i * 1000003 + 7));
+    }
+    return out;
+}
+
+TEST(merkle_tree, hash_pair_is_mimc_sponge) {
+    const Fp254 left(uint64_t(1));
+    const Fp254 right(uint64_t(2));
+    ByteVec2D digests;
+    hash::mimc_sponge({left.big_int().bytes(BE), right.big_int().bytes(BE)}, 1, {}, digests);
+    EXPECT_EQ(BigInt(digests[0], BE), hash::mimc_hash_pair(left, right).big_int());
+
+    const auto values = leaves(22);
+    std::vector<Fp254> out(values.size() / 2);
+    hash::mimc_hash_pairs(values, out);
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(hash::mimc_hash_pair(values[i * 2], values[i * 2 + 1]), out[i]);
+    }
+}
+
+TEST(merkle_tree, tornado_zeros) {
+    MerkleTree tree(20, TORNADO_ZERO);
+    EXPECT_EQ(BigInt("2fe54c60d3acabf3343a35b6eba15db4821b340f76e741e2249685ed4899af6c", 16), tree.zero(0).big_int());
+    EXPECT_EQ(BigInt("256a6135777eee2fd26f54b8b7037a25439d5235caee224154186d2b8a52e31d", 16), tree.zero(1).big_int());
+    EXPECT_EQ(tree.zero(20), tree.root());
+    EXPECT_TRUE(tree.is_known_root(tree.zero(20)));
+    EXPECT_EQ(0, tree.size());
+    EXPECT_EQ(uint64_t(1) << 20, tree.capacity());
+}
+
+TEST(merkle_tree, insert_and_path) {
+    MerkleTree tree(5, TORNADO_ZERO);
+    const auto values = leaves(13);
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(i, tree.insert(values[i]));
+        // Every inserted leaf proves against the latest root
+        for (size_t j = 0; j <= i; ++j) {
+            const auto path = tree.path(j);
+            EXPECT_EQ(5, path.siblings.size());
+            EXPECT_EQ(tree.root(), MerkleTree::compute_root(values[j], path));
+        }
+    }
+    // Root of 13 leaves computed level by level from scratch
+    std::vector<Fp254> level = values;
+    level.resize(32, TORNADO_ZERO);
+    while (level.size() > 1) {
+        std::vector<Fp254> parents(level.size() / 2);
+        hash::mimc_hash_pairs(level, parents);
+        level = parents;
+    }
+    EXPECT_EQ(level[0], tree.root());
+    EXPECT_EQ(values[3], tree.leaf(3));
+    EXPECT_THROW((void)tree.path(13), std::out_of_range);
+    EXPECT_FALSE(MerkleTree::compute_root(values[4], tree.path(3)) == tree.root());
+}
+
+TEST(merkle_tree, bulk_insert_matches_incremental) {
+    const auto values = leaves(1100);
+    MerkleTree expected(11);
+    for (const auto& value : values) {
+        (void)expected.insert(value);
+    }
+    for (uint32_t threads : {1u, 4u}) {
+        // From empty, then appended in uneven chunks
+        MerkleTree built(11);
+        built.insert(values, threads);
+        EXPECT_EQ(expected.root(), built.root());
+        MerkleTree appended(11);
+        for (size_t first = 0, chunk = 1; first < values.size(); first += chunk, chunk = chunk * 3 + 1) {
+            appended.insert(std::span(values).subspan(first, std::min(chunk, values.size() - first)), threads);
+        }
+        EXPECT_EQ(expected.root(), appended.root());
+        for (uint64_t index : {uint64_t(0), uint64_t(1), uint64_t(513), uint64_t(1099)}) {
+            EXPECT_EQ(expected.path(index).siblings, appended.path(index).siblings);
+        }
+        // Single inserts keep working after a bulk one
+        (void)appended.insert(Fp254::one());
+        EXPECT_EQ(appended.root(), MerkleTree::compute_root(Fp254::one(), appended.path(1100)));
+    }
+}
+
+TEST(merkle_tree, root_history_and_capacity) {
+    MerkleTree tree(2, Fp254::zero(), 3);
+    const auto empty = tree.root();
+    std::vector<Fp254> roots;
+    for (const auto& value : leaves(4)) {
+        (void)tree.insert(value);
+        roots.push_back(tree.root());
+    }
+    // The last 3 roots are known, older ones dropped out
+    EXPECT_FALSE(tree.is_known_root(empty));
+    EXPECT_FALSE(tree.is_known_root(roots[0]));
+    EXPECT_TRUE(tree.is_known_root(roots[1]));
+    EXPECT_TRUE(tree.is_known_root(roots[3]));
+    EXPECT_THROW((void)tree.insert(Fp254::one()), std::length_error);
+    EXPECT_THROW(MerkleTree(0), std::invalid_argument);
+    EXPECT_THROW(MerkleTree(33), std::invalid_argument);
+    MerkleTree small(1);
+    EXPECT_THROW(small.insert(leaves(3)), std::length_error);
+}
+
+TEST(merkle_tree, performance_bulk_insert_2_pow_14_leaves) {
+    const auto values = leaves(1 << 14);
+    PERFORMANCE_TEST(1, {
+        MerkleTree tree(20);
+        tree.insert(values, 4);
+    })
+}
+
+TEST(merkle_tree, performance_insert_depth_20) {
+    MerkleTree tree(20);
+    const auto values = leaves(ONE_THOUSAND);
+    PERFORMANCE_TEST(ONE_THOUSAND, {
+        (void)tree.insert(values[_]);
+    })
+}
+
+} // namespace iden3math::merkle
@@ -124,6 +124,69 @@ class TestBabyjub(unittest.TestCase):
         mul = ec.babyjub.mul_scalar(ec.babyjub.generator(), repeat_times)
         self.assertEqual(sum, mul)
 
+    def test_mul_scalar_wnaf_ct(self):
+        for i in range(50):
+            k = self.scalar * (i + 1) + i
+            expected = ec.babyjub.mul_scalar(ec.babyjub.generator(), k)
+            for width in range(2, 9):
+                self.assertEqual(expected, ec.babyjub.mul_scalar_wnaf(ec.babyjub.generator(), k, width))
+            self.assertEqual(expected, ec.babyjub.mul_scalar_wnaf(ec.babyjub.generator(), k))
+            self.assertEqual(expected, ec.babyjub.mul_scalar_ct(ec.babyjub.generator(), k))
+
+    def test_mul_base(self):
+        for i in range(50):
+            k = self.scalar * (i + 1) + i
+            self.assertEqual(ec.babyjub.mul_scalar(ec.babyjub.generator(), k), ec.babyjub.mul_base(k))
+        self.assertEqual(ec.babyjub.zero(), ec.babyjub.mul_base(ec.babyjub.group_order()))
+
+    def test_msm(self):
+        points = [ec.babyjub.mul_base(i + 1) for i in range(40)]
+        scalars = [self.scalar * (i + 1) + i for i in range(40)]
+        expected = ec.babyjub.zero()
+        for p, k in zip(points, scalars):
+            expected = ec.babyjub.add(expected, ec.babyjub.mul_scalar(p, k))
+        self.assertEqual(expected, ec.babyjub.msm(points, scalars))
+        self.assertEqual(expected, ec.babyjub.msm(points, scalars, 4))
+
+    def test_decompress_batch(self):
+        for endian in [Endian.LE, Endian.BE]:
+            points = [ec.babyjub.mul_base(self.scalar + i) for i in range(50)]
+            packed = [ec.babyjub.compress(p, endian) for p in points]
+            self.assertEqual(points, ec.babyjub.decompress_batch(packed, endian))
+            self.assertEqual(points, ec.babyjub.decompress_batch(packed, endian, 3))
+            # One contiguous buffer, read in place
+            flat = b"".join(packed)
+            self.assertEqual(points, ec.babyjub.decompress_batch(flat, endian, 3))
+            self.assertEqual(points, ec.babyjub.decompress_batch(memoryview(flat), endian))
+            with self.assertRaises(ValueError):
+                ec.babyjub.decompress_batch(flat[:-1], endian)
+
+    def test_numpy_batch(self):
+        try:
+            import numpy as np
+        except ImportError:
+            self.skipTest("numpy is not installed")
+        for endian in [Endian.LE, Endian.BE]:
+            order = 'little' if Endian.LE == endian else 'big'
+            points = [ec.babyjub.mul_base(self.scalar + i) for i in range(50)]
+            xy = np.array([[list(p.x().to_bytes(32, order)), list(p.y().to_bytes(32, order))] for p in points], dtype=np.uint8)
+            packed = ec.babyjub.compress_batch(xy, endian, 3)
+            self.assertEqual([bytes(ec.babyjub.compress(p, endian)) for p in points], [bytes(row) for row in packed])
+            packed[7] = 0xff
+            coordinates, valid = ec.babyjub.decompress_batch(packed, endian, 3)
+            self.assertFalse(valid[7])
+            self.assertTrue(valid[:7].all() and valid[8:].all())
+            self.assertTrue((coordinates[:7] == xy[:7]).all() and (coordinates[8:] == xy[8:]).all())
+
+    def test_release_gil(self):
+        # Same results when called from several Python threads at once
+        from concurrent.futures import ThreadPoolExecutor
+        scalars = [self.scalar + i for i in range(16)]
+        expected = [ec.babyjub.mul_scalar(ec.babyjub.generator(), k) for k in scalars]
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            results = list(pool.map(lambda k: ec.babyjub.mul_scalar(ec.babyjub.generator(), k), scalars))
+        self.assertEqual(expected, results)
+
     def test_in_curve(self):
         # Invalid points
         invalid_points = [
@@ -1,3 +1,4 @@
+import time
 import unittest
 from iden3math import Fp1
 from iden3math import prime
@@ -189,6 +190,13 @@ class TestFp1(unittest.TestCase):
             self.assertEqual(f.mul(f.mod_inv(p - 1), p - 1), 1)
             self.assertEqual(f.mul(f.mod_inv(p + 1), p + 1), 1)
 
+    def test_batch_inv(self):
+        for p in self.primes:
+            f = Fp1(p)
+            values = [1, -1, 2, -2, 0, p - 1, p, p + 1]
+            expected = [f.mod_inv(v) or 0 for v in values]
+            self.assertEqual(f.batch_inv(values), expected)
+
     def test_neg(self):
         for p in self.primes:
             f = Fp1(p)
@@ -210,3 +218,18 @@ class TestFp1(unittest.TestCase):
             self.assertTrue(f.has_sqrt(a), f"Should have sqrt: {a}")
         for a in no_sqrt:
             self.assertFalse(f.has_sqrt(a), f"Should not have sqrt: {a}")
+
+    def test_performance_conversion(self):
+        # Binding overhead, every call converts one 254-bit int in and one out
+        f = Fp1(prime.bn254())
+        a = prime.bn254() - 1
+        rounds = 100000
+        start = time.perf_counter()
+        for _ in range(rounds):
+            r = f.mod_reduce(a)
+        elapsed = time.perf_counter() - start
+        print(f"mod_reduce() round trip: {elapsed / rounds * 1e6:.3f}us each")
+        self.assertEqual(r, a)
+        # Negative and wide values take the same path
+        for v in [-a, a ** 3, -(a ** 3), 2 ** 512, -(2 ** 512) + 1]:
+            self.assertEqual(Fp1(17).mod_reduce(v), v % 17)
@@ -12,6 +12,16 @@ class TestHashBlake256(unittest.TestCase):
         digest = hash.blake256(input)
         self.assertTrue(len(digest) == 0)
 
+    def test_streaming(self):
+        preimage = bytes(range(256)) * 3
+        expected = hash.blake256(preimage)
+        hasher = hash.Blake256()
+        for i in range(0, len(preimage), 13):
+            hasher.update(data=memoryview(preimage)[i:i + 13])
+        self.assertEqual(expected, hasher.finalize())
+        # Reset after finalize, nothing absorbed hashes the empty message
+        self.assertEqual("716f6e863f744b9ac22c97ec7b76ea5f5908bc5b2f67c61510bfc4751384ea7a", hasher.finalize().hex())
+
     def test_single_byte_0x00(self):
         expected = "0ce8d4ef4dd7cd8d62dfded9d4edb0a774ae6a41929a74da23109e8f11139c87"
         input = bytes([0x00])
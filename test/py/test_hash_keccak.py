@@ -27,6 +27,24 @@ class TestHashKeccak256(unittest.TestCase):
         digest = hash.keccak256(preimage)
         self.assertEqual(expected, digest.hex())
 
+    def test_buffer_protocol(self):
+        preimage = b"Transfer(address,address,uint256)"
+        expected = "ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef"
+        self.assertEqual(expected, hash.keccak256(bytearray(preimage)).hex())
+        self.assertEqual(expected, hash.keccak256(memoryview(preimage)).hex())
+        self.assertEqual(expected, hash.keccak256(memoryview(b"__" + preimage)[2:]).hex())
+
+    def test_streaming(self):
+        preimage = b"Transfer(address,address,uint256)" * 10
+        expected = hash.keccak256(preimage)
+        hasher = hash.Keccak256()
+        for i in range(0, len(preimage), 13):
+            hasher.update(memoryview(preimage)[i:i + 13])
+        self.assertEqual(expected, hasher.finalize())
+        # Reset after finalize
+        hasher.update(data="Transfer(address,address,uint256)")
+        self.assertEqual("ddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef", hasher.finalize().hex())
+
     def test_same_container_for_input_and_output(self):
         seed = "keccak256"
         expected = "c0168e0d8493e7a9939bce2051cd56fa67ad757c9af47ad0232d4a39ae760dd8"
@@ -351,3 +369,15 @@ class TestHashKeccak256(unittest.TestCase):
         expected = "1a66fd6d2d37cb05ba1d68d3c1a7bf93e0430e907495b4351f4eec25f882b751"
         digest = hash.keccak256(preimage)
         self.assertEqual(expected, digest.hex())
+
+    def test_batch(self):
+        try:
+            import numpy as np
+        except ImportError:
+            self.skipTest("numpy is not installed")
+        rows = [bytes([i] * 32) for i in range(64)]
+        data = np.frombuffer(b"".join(rows), dtype=np.uint8).reshape(64, 32)
+        expected = np.array([list(hash.keccak256(r)) for r in rows], dtype=np.uint8)
+        self.assertTrue((expected == hash.keccak256_batch(data)).all())
+        self.assertTrue((expected == hash.keccak256_batch(data, 4)).all())
+        self.assertEqual((0, 32), hash.keccak256_batch(np.zeros((0, 32), dtype=np.uint8)).shape)
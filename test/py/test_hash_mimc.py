@@ -214,3 +214,19 @@ class TestHashMiMCSponge(unittest.TestCase):
 
         # Should not be equal to the first call
         self.assertEqual(expected[0], digests[0].hex())
+
+    def test_batch(self):
+        try:
+            import numpy as np
+        except ImportError:
+            self.skipTest("numpy is not installed")
+        pairs = [[(i * 2).to_bytes(32, 'big'), (i * 2 + 1).to_bytes(32, 'big')] for i in range(32)]
+        data = np.array([[list(left), list(right)] for left, right in pairs], dtype=np.uint8)
+        key = (7).to_bytes(32, 'big')
+        for outputs in [1, 3]:
+            expected = np.array([[list(d) for d in hash.mimc_sponge(p, outputs, key)] for p in pairs], dtype=np.uint8)
+            self.assertTrue((expected == hash.mimc_sponge_batch(data, outputs, key)).all())
+            self.assertTrue((expected == hash.mimc_sponge_batch(data, outputs, key, threads=4)).all())
+        # One preimage per row
+        expected = np.array([list(hash.mimc_sponge([p[0]], 1, b'')[0]) for p in pairs], dtype=np.uint8)
+        self.assertTrue((expected == hash.mimc_sponge_batch(data[:, 0, :])[:, 0, :]).all())
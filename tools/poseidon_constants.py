@@ -0,0 +1,273 @@
+"""
+Generate src/cxx/hash/poseidon_constants.h, the circomlib Poseidon constants of state widths 2 to 17
+
+Round constants and MDS matrices come from the Grain LFSR of the reference generate_parameters_grain.sage
+(field 1, S-box x^5, n = 254, R_F = 8, R_P as circomlib), the same values circomlib ships. They are then
+rewritten for the optimized permutation and checked against the plain one before anything is written
+
+Cauchy matrices are drawn again until they pass the subspace trail checks of the reference script (algorithms 1 to 3
+of "Proving Resistance Against Infinitely Long Subspace Trails", one S-box per partial round). The widths with a
+circomlib vector in test/cxx/hash/poseidon_test.cxx all keep their first matrix, the tool reports any width redrawn
+
+    python3 tools/poseidon_constants.py [output]
+    python3 tools/poseidon_constants.py --vectors    Plain permutation of [1, n] for n = 1 to 16
+"""
+
+import os
+import sys
+
+P = 0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001
+FULL_ROUNDS = 8
+PARTIAL_ROUNDS = [56, 57, 56, 60, 60, 63, 64, 63, 60, 66, 60, 65, 70, 60, 64, 68] # Widths 2 to 17
+WIDTHS = range(2, 18)
+
+
+class Grain:
+    def __init__(self, t: int, partial: int):
+        bits = '01' + '0000' + format(254, '012b') + format(t, '012b') + format(FULL_ROUNDS, '010b') + format(partial, '010b') + '1' * 30
+        self.state = [int(b) for b in bits]
+        for _ in range(160):
+            self.step()
+
+    def step(self) -> int:
+        s = self.state
+        bit = s[62] ^ s[51] ^ s[38] ^ s[23] ^ s[13] ^ s[0]
+        s.pop(0)
+        s.append(bit)
+        return bit
+
+    # Bits come in pairs, the second one is kept when the first one is set
+    def bit(self) -> int:
+        while True:
+            keep = self.step()
+            bit = self.step()
+            if keep:
+                return bit
+
+    def field(self, reject: bool) -> int:
+        while True:
+            value = 0
+            for _ in range(254):
+                value = (value << 1) | self.bit()
+            if not reject:
+                return value % P
+            if value < P:
+                return value
+
+
+def cauchy(grain: Grain, t: int):
+    # Cauchy matrix 1 / (x_i + y_j) over 2t distinct random elements
+    while True:
+        values = [grain.field(False) for _ in range(2 * t)]
+        while len(set(values)) != len(values):
+            values = [grain.field(False) for _ in range(2 * t)]
+        xs, ys = values[:t], values[t:]
+        if all(0 != (x + y) % P for x in xs for y in ys):
+            return [[pow(x + y, P - 2, P) for y in ys] for x in xs]
+
+
+def rank(vectors) -> int:
+    rows = [v[:] for v in vectors]
+    found = 0
+    for c in range(len(rows[0])):
+        pivot = next((r for r in range(found, len(rows)) if rows[r][c]), None)
+        if pivot is None:
+            continue
+        rows[found], rows[pivot] = rows[pivot], rows[found]
+        scale = pow(rows[found][c], P - 2, P)
+        rows[found] = [x * scale % P for x in rows[found]]
+        for r in range(found + 1, len(rows)):
+            if rows[r][c]:
+                f = rows[r][c]
+                rows[r] = [(x - f * y) % P for x, y in zip(rows[r], rows[found])]
+        found += 1
+    return found
+
+
+def spans(m, v) -> bool:
+    # Whether v, m * v, m^2 * v, ... span the whole space, i.e. v is in no proper subspace invariant under m
+    t = len(m)
+    vectors = [v]
+    for _ in range(t - 1):
+        vectors.append(apply(m, vectors[-1]))
+    return t == rank(vectors)
+
+
+def trail_free(mds) -> bool:
+    """
+    Subspace trail checks of the reference script with the single S-box of a partial round on state[0]:
+    algorithm 1, no power M^i, 1 <= i < t, is a multiple of the identity or leaves a subspace of {state[0] = 0} invariant
+    algorithm 2, the subspace spanned by e_0 under M is the whole space
+    algorithm 3, the same for M^r, 2 <= r <= 4t
+    """
+    t = len(mds)
+    e0 = [1] + [0] * (t - 1)
+    power = mds
+    for i in range(1, 4 * t + 1):
+        if i < t:
+            if all(power[r][c] == (power[0][0] if r == c else 0) for r in range(t) for c in range(t)):
+                return False
+            # An invariant subspace of {state[0] = 0} under M^i is one orthogonal to e_0 under the transpose of M^i
+            if not spans([list(col) for col in zip(*power)], e0):
+                return False
+        if not spans(power, e0):
+            return False
+        power = mul(power, mds)
+    return True
+
+
+def reference_params(t: int):
+    partial = PARTIAL_ROUNDS[t - 2]
+    grain = Grain(t, partial)
+    constants = [grain.field(True) for _ in range((FULL_ROUNDS + partial) * t)]
+    mds = cauchy(grain, t)
+    while not trail_free(mds):
+        print('Width %d: Cauchy matrix drawn again' % t, file=sys.stderr)
+        mds = cauchy(grain, t)
+    return partial, [constants[r * t:(r + 1) * t] for r in range(FULL_ROUNDS + partial)], mds
+
+
+def mul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b))) % P for j in range(len(b[0]))] for i in range(len(a))]
+
+
+def apply(m, v):
+    return [sum(m[i][j] * v[j] for j in range(len(v))) % P for i in range(len(m))]
+
+
+def inverse(m):
+    n = len(m)
+    a = [row[:] + [int(i == j) for j in range(n)] for i, row in enumerate(m)]
+    for c in range(n):
+        pivot = next(r for r in range(c, n) if a[r][c])
+        a[c], a[pivot] = a[pivot], a[c]
+        scale = pow(a[c][c], P - 2, P)
+        a[c] = [x * scale % P for x in a[c]]
+        for r in range(n):
+            if r != c and a[r][c]:
+                f = a[r][c]
+                a[r] = [(x - f * y) % P for x, y in zip(a[r], a[c])]
+    return [row[n:] for row in a]
+
+
+def optimize(t: int, partial: int, constants, mds):
+    """
+    Full rounds:    state += full[r], state = state ^ 5, state = mds * state (pre instead of mds before the partial rounds)
+    Partial rounds: state[0] += partial[r], state[0] = state[0] ^ 5, then the sparse matrix of the round
+    """
+    half = FULL_ROUNDS // 2
+    # Only state[0] meets the S-box in a partial round, the other constants are carried into the next round
+    constants = [c[:] for c in constants]
+    for r in range(half, half + partial):
+        carried = apply(mds, [0] + constants[r][1:])
+        constants[r + 1] = [(a + b) % P for a, b in zip(constants[r + 1], carried)]
+        constants[r] = constants[r][:1] + [0] * (t - 1)
+    # Split each partial round's matrix A = S * diag(1, A'), S is the identity but for its first row and column.
+    # diag(1, A') leaves state[0] alone so it moves ahead of the S-box into the round before, last round first
+    sparse = [None] * partial
+    a = mds
+    for r in reversed(range(partial)):
+        inner = [row[1:] for row in a[1:]]
+        row = [a[0][0]] + apply([list(col) for col in zip(*inverse(inner))], a[0][1:])
+        sparse[r] = row + [a[i][0] for i in range(1, t)]
+        a = mul([[1] + [0] * (t - 1)] + [[0] + inner_row for inner_row in inner], mds)
+    full = constants[:half] + constants[half + partial:]
+    return full, [c[0] for c in constants[half:half + partial]], a, sparse
+
+
+def reference_permute(state, partial, constants, mds):
+    for r in range(FULL_ROUNDS + partial):
+        state = [(s + c) % P for s, c in zip(state, constants[r])]
+        if FULL_ROUNDS // 2 <= r < FULL_ROUNDS // 2 + partial:
+            state[0] = pow(state[0], 5, P)
+        else:
+            state = [pow(s, 5, P) for s in state]
+        state = apply(mds, state)
+    return state
+
+
+def optimized_permute(state, full, partial, mds, pre, sparse):
+    t = len(state)
+    half = FULL_ROUNDS // 2
+    for r in range(half):
+        state = [pow((s + c) % P, 5, P) for s, c in zip(state, full[r])]
+        state = apply(pre if half - 1 == r else mds, state)
+    for c, s in zip(partial, sparse):
+        x = pow((state[0] + c) % P, 5, P)
+        first = (s[0] * x + sum(s[j] * state[j] for j in range(1, t))) % P
+        state = [first] + [(state[i] + s[t + i - 1] * x) % P for i in range(1, t)]
+    for r in range(half, FULL_ROUNDS):
+        state = [pow((s + c) % P, 5, P) for s, c in zip(state, full[r])]
+        state = apply(mds, state)
+    return state
+
+
+def element(x: int) -> str:
+    mont = x * (1 << 256) % P
+    return 'Fp254::from_mont({' + ', '.join('0x%016x' % ((mont >> (64 * i)) & (2 ** 64 - 1)) for i in range(4)) + '})'
+
+
+def vector(values, indent: str) -> str:
+    return '{{\n' + ''.join(indent + '    ' + element(v) + ',\n' for v in values) + indent + '}}'
+
+
+def matrix(rows, indent: str) -> str:
+    return '{{\n' + ''.join(indent + '    ' + vector(row, indent + '    ') + ',\n' for row in rows) + indent + '}}'
+
+
+HEADER = """#pragma once
+
+// Generated by tools/poseidon_constants.py, do not edit
+
+#include <iden3math/fp254.h>
+#include <array>
+#include <cstddef>
+
+namespace iden3math::hash::poseidon_params {
+
+static constexpr size_t FULL_ROUNDS = %d;
+
+// Constants of state width T in Montgomery form, laid out for the optimized permutation (see poseidon.cxx)
+template <size_t T, size_t PARTIAL>
+struct Params {
+    std::array<std::array<Fp254, T>, FULL_ROUNDS>     full;    // Added to the state before the S-boxes of each full round
+    std::array<Fp254, PARTIAL>                        partial; // Added to state[0] before its S-box in each partial round
+    std::array<std::array<Fp254, T>, T>               mds;     // state[i] = sum(mds[i][j] * state[j])
+    std::array<std::array<Fp254, T>, T>               pre;     // Replaces mds in the last full round before the partial rounds
+    std::array<std::array<Fp254, 2 * T - 1>, PARTIAL> sparse;  // First row then the rest of the first column of each partial round
+};
+"""
+
+
+def vectors():
+    for t in WIDTHS:
+        partial, constants, mds = reference_params(t)
+        print(t - 1, reference_permute(list(range(t)), partial, constants, mds)[0])
+
+
+def main():
+    if len(sys.argv) > 1 and '--vectors' == sys.argv[1]:
+        vectors()
+        return
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), '..', 'src', 'cxx', 'hash', 'poseidon_constants.h')
+    text = HEADER % FULL_ROUNDS
+    for t in WIDTHS:
+        partial, constants, mds = reference_params(t)
+        full, scalars, pre, sparse = optimize(t, partial, constants, mds)
+        state = list(range(t))
+        if reference_permute(state, partial, constants, mds) != optimized_permute(state, full, scalars, mds, pre, sparse):
+            raise RuntimeError('Optimized permutation of width %d differs from the reference' % t)
+        text += '\ninline constexpr Params<%d, %d> WIDTH_%d = {\n' % (t, partial, t)
+        text += '    ' + matrix(full, '    ') + ',\n'
+        text += '    ' + vector(scalars, '    ') + ',\n'
+        text += '    ' + matrix(mds, '    ') + ',\n'
+        text += '    ' + matrix(pre, '    ') + ',\n'
+        text += '    ' + matrix(sparse, '    ') + ',\n'
+        text += '};\n'
+    text += '\n} // namespace iden3math::hash::poseidon_params\n'
+    with open(output, 'w', newline='\r\n') as f: # Line endings of the repository
+        f.write(text)
+
+
+if __name__ == '__main__':
+    main()